@@ -13,6 +13,8 @@ public:
     static Environment& instance();
     void add(const EnvEntity&);
     const EnvEntity& get(const std::string&) const;
+    bool has(const std::string&) const;
+    void set_body(const std::string&,const Body&);
     const std::unordered_map<std::string,EnvEntity>& all() const;
 private:
     std::unordered_map<std::string,EnvEntity> entities;
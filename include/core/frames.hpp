@@ -0,0 +1,28 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+// Earth-fixed frame: ECEF = R3(GMST) * ECI (no precession/nutation/polar
+// motion), WGS-84 ellipsoid.
+static constexpr double WGS84_A_KM = 6378.137;
+static constexpr double WGS84_F = 1.0/298.257223563;
+static constexpr double WGS84_E2 = WGS84_F*(2.0 - WGS84_F);
+static constexpr double OMEGA_EARTH_RAD_S = 7.2921159e-5;
+
+// Position/velocity rotation at sidereal angle gmst (rad). Velocities include
+// the w x r transport term.
+void eci_to_ecef(double gmst, const double r_eci[3], const double v_eci[3], double r_ecef[3], double v_ecef[3]);
+void ecef_to_eci(double gmst, const double r_ecef[3], const double v_ecef[3], double r_eci[3], double v_eci[3]);
+
+// WGS-84 geodetic <-> ECEF. The inverse is Bowring's closed form (one
+// auxiliary-angle step): sub-millimetre near the surface, centimetres in
+// LEO, a few decimetres at GEO -- ample for ground tracks.
+std::array<double,3> geodetic_to_ecef(double lat_deg, double lon_deg, double alt_km);
+void ecef_to_geodetic(double x, double y, double z, double& lat_deg, double& lon_deg, double& alt_km);
+
+// Sub-satellite points for n ECI positions at Julian date jd. Positions are
+// read with a stride in doubles (Body records: 7), outputs are SoA. The
+// rotation and Bowring terms run as one arithmetic-only loop that the
+// compiler vectorizes; only the final angles use atan2.
+void eci_to_lla_batch(double jd, size_t n, const double* xyz, size_t stride,
+                      double* lat_deg, double* lon_deg, double* alt_km);
@@ -1,5 +1,11 @@
 #pragma once
 #include <array>
+#include <string>
+// WGS-84 geodetic (see core/frames.hpp).
 std::array<double,3> lla_to_ecef(double lat_deg,double lon_deg,double alt_km);
 double local_solar_time_hours(double lon_deg,double jd);
 double ecef_lon_deg(double x,double y,double z);
+// Greenwich mean sidereal angle (IAU 1982), radians in [0, 2pi).
+double gmst_rad(double jd);
+// Julian date to "YYYY-MM-DDTHH:MMZ" (or "...HH:MM:SSZ").
+std::string jd_to_utc(double jd, bool seconds = false);
@@ -1,17 +1,29 @@
 #pragma once
+#include <cstdint>
 #include <fstream>
 #include <string>
+#include <vector>
 #include "physics/engine.hpp"
 
 class OutputWriter {
 public:
     OutputWriter()=default;
     void open(const std::string& path,double rate_s);
+    // Reopen a partially written file at a checkpointed position.
+    bool resume(const std::string& path,double rate_s,double next_t_s,uint64_t offset);
+    // Writes a row per body when t reaches the next output time. Ground
+    // tracks use the engine's own clock (e.time), which is when the states
+    // are valid, not the caller's loop time.
     void tick(double t,const PhysicsEngine& e);
     bool enabled() const { return is_on; }
+    double next_time() const { return next_t; }
+    uint64_t position();
 private:
     std::ofstream out;
     double rate=0.0;
     double next_t=0.0;
     bool is_on=false;
+
+    // Ground-track scratch (sub-satellite lat/lon/alt per body).
+    std::vector<double> lat, lon, alt;
 };
@@ -0,0 +1,86 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+inline size_t worker_count(){
+    const unsigned n = std::thread::hardware_concurrency();
+    return n ? (size_t)n : 1;
+}
+
+// Number of contiguous slices parallel_for will split [0,n) into.
+inline size_t parallel_slices(size_t n, size_t grain){
+    if(n == 0) return 0;
+    grain = std::max<size_t>(1, grain);
+    return std::max<size_t>(1, std::min(worker_count(), (n + grain - 1) / grain));
+}
+
+// Calls f(begin, end, slice) over contiguous slices of [0,n); slice 0 runs
+// on the calling thread. Slice boundaries depend only on n and grain.
+template<class F>
+void parallel_for(size_t n, size_t grain, F&& f){
+    const size_t slices = parallel_slices(n, grain);
+    if(slices == 0) return;
+    if(slices == 1){ f((size_t)0, n, (size_t)0); return; }
+
+    const size_t per = (n + slices - 1) / slices;
+    std::vector<std::thread> pool;
+    pool.reserve(slices - 1);
+    for(size_t s=1;s<slices;s++){
+        const size_t b = std::min(n, s*per);
+        const size_t e = std::min(n, b + per);
+        pool.emplace_back([&f,b,e,s]{ f(b, e, s); });
+    }
+    f((size_t)0, std::min(n, per), (size_t)0);
+    for(auto& t : pool) t.join();
+}
+
+// Runs f(i) for every task i in [0,n) on up to `threads` workers (0 = all
+// cores). Tasks are dealt round-robin into per-worker deques; a worker
+// takes from the back of its own deque and steals from the front of the
+// others once it runs dry, so uneven task costs still balance out.
+template<class F>
+void work_stealing_for(size_t n, size_t threads, F&& f){
+    if(n == 0) return;
+    if(threads == 0) threads = worker_count();
+    threads = std::min(threads, n);
+
+    struct Lane{
+        std::mutex m;
+        std::deque<size_t> q;
+    };
+    std::vector<std::unique_ptr<Lane>> lanes;
+    lanes.reserve(threads);
+    for(size_t w=0;w<threads;w++) lanes.push_back(std::make_unique<Lane>());
+    for(size_t i=0;i<n;i++) lanes[i % threads]->q.push_back(i);
+
+    auto take = [&](size_t w)->std::optional<size_t>{
+        {
+            Lane& own = *lanes[w];
+            std::lock_guard<std::mutex> lk(own.m);
+            if(!own.q.empty()){ size_t i = own.q.back(); own.q.pop_back(); return i; }
+        }
+        for(size_t k=1;k<threads;k++){
+            Lane& victim = *lanes[(w + k) % threads];
+            std::lock_guard<std::mutex> lk(victim.m);
+            if(!victim.q.empty()){ size_t i = victim.q.front(); victim.q.pop_front(); return i; }
+        }
+        return std::nullopt;
+    };
+
+    // No tasks are added after start, so an empty sweep means done.
+    auto worker = [&](size_t w){
+        while(auto i = take(w)) f(*i);
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for(size_t w=1;w<threads;w++) pool.emplace_back(worker, w);
+    worker(0);
+    for(auto& t : pool) t.join();
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+
+// s without trailing spaces or a trailing CR; TLE names are space-padded
+// and request lines may end in CRLF.
+inline std::string trimmed(std::string s){
+    while(!s.empty() && (s.back() == ' ' || s.back() == '\r')) s.pop_back();
+    return s;
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <istream>
 #include <string>
 #include <vector>
 
@@ -13,8 +14,22 @@ struct TLE {
     double argp_rad = 0.0;
     double M_rad = 0.0;
     double n_rev_per_day = 0.0;
+
+    // Line 1
+    double epoch_jd = 0.0;   // UTC Julian date
+    double bstar = 0.0;      // SGP4 drag term, 1/earth radii
 };
 
+// SGP4 B* to ballistic coefficient Cd*A/m (m^2/kg): B = 2 B* / rho0,
+// rho0 = 0.15696615 kg/m^2/ER.
+inline double bstar_to_bc_m2_kg(double bstar){ return 2.0*bstar/0.15696615; }
+
+// Reads the next 3-line record, skipping malformed ones. False at end of stream.
+bool read_next_tle(std::istream& in, TLE& out);
+
+// Counts well-formed 3-line records without parsing them.
+size_t count_tles_in_file(const std::string& path);
+
 bool load_tles_from_file(const std::string& path, std::vector<TLE>& out);
 
 void tle_mean_to_eci(const TLE& t, double mu_km3_s2,
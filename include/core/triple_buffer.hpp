@@ -0,0 +1,40 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Single-writer, single-reader triple buffer. The writer fills back() and
+// publish()es it; the reader calls update() and reads front(). Neither
+// side ever waits: publishing swaps the back slot with the shared middle
+// one, and update() swaps the front slot with the middle one when a newer
+// value is there, so the reader always holds a whole, stable value and
+// intermediate values it never asked for are simply overwritten. Slots are
+// reused, never reallocated.
+template<class T>
+class TripleBuffer{
+public:
+    // Writer side.
+    T& back(){ return slot[back_idx].value; }
+    void publish(){
+        const uint8_t prev = middle.exchange(back_idx | FRESH, std::memory_order_acq_rel);
+        back_idx = prev & INDEX;
+    }
+
+    // Reader side: true if front() changed.
+    bool update(){
+        if(!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        const uint8_t prev = middle.exchange(front_idx, std::memory_order_acq_rel);
+        front_idx = prev & INDEX;
+        return true;
+    }
+    const T& front() const { return slot[front_idx].value; }
+
+private:
+    static constexpr uint8_t INDEX = 3;
+    static constexpr uint8_t FRESH = 4;
+
+    struct alignas(64) Slot{ T value; };
+    Slot slot[3];
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t back_idx = 0;       // writer-owned
+    alignas(64) uint8_t front_idx = 2;      // reader-owned
+};
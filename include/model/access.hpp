@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+struct AccessOptions{
+    std::string output;             // CSV path (default stdout)
+    double start_jd = 0.0;          // 0 = latest TLE epoch
+    double hours = 24.0;
+    double min_elevation_deg = 10.0;
+    double step_s = 30.0;           // passes shorter than this can be missed
+    size_t threads = 0;             // 0 = all cores
+};
+
+// Rise/set windows of every TLE satellite over every ground site registered
+// in Environment (the global cities list). Orbits follow the secular J2
+// propagator; sites are tested with a horizon-cone bound first, skipping
+// ahead while a satellite cannot reach the cone, and crossings are refined
+// by Illinois false position. Writes one CSV row per window.
+bool run_access(const std::string& tle_path, const AccessOptions& opt);
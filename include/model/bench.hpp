@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+
+// Times every pre-instantiated force pipeline on the same LEO shell and
+// prints one line per model: name, bodies, steps, ns per body-step.
+// Expects the solar system to be loaded (third-body models).
+bool run_force_bench(size_t bodies, int steps);
+
+// Solves the same seeded set of LEO..GEO transfers with each Lambert
+// method: ns per solve, two-body miss distance of every returned solution,
+// agreement of the single-revolution departure velocities, then the same
+// with multi-revolution branches.
+bool run_lambert_bench(size_t cases);
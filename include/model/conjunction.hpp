@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include "orbit/collision.hpp"
+
+struct PcOptions{
+    std::string output;             // CSV path (default stdout)
+    PcMethod method = PC_AUTO;
+    size_t threads = 0;             // 0 = all cores
+};
+
+// Probability of collision for screened conjunction events. The input CSV
+// has one event per row (an optional header starting "id1" and '#' lines
+// are skipped):
+//   id1,id2,tca_utc, rx,ry,rz (km), vx,vy,vz (km/s),
+//   c1 xx,xy,xz,yy,yz,zz (km^2), c2 xx,xy,xz,yy,yz,zz (km^2), hbr1_m,hbr2_m
+// with r, v of object 2 relative to object 1 at TCA and both position
+// covariances in ECI. Events are evaluated in parallel; writes one CSV row
+// per event, highest Pc first.
+bool run_pc(const std::string& events_path, const PcOptions& opt);
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include "physics/engine.hpp"
+#include "sim/scenario.hpp"
+
+// Runs the scenario and writes every body's shadow intervals as CSV
+// (entity, penumbra|umbra, start/end JD and UTC, duration). "penumbra"
+// spans first to last penumbral contact and so contains the umbra pass.
+// The Sun vector is computed once per step and the whole catalog is
+// classified in one batch; crossings are then located between steps on a
+// cubic Hermite arc, so intervals are sub-second at the scenario timestep.
+bool run_eclipses(PhysicsEngine& e, const ScenarioCfg& cfg, const std::string& output);
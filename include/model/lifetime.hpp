@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+
+struct LifetimeOptions{
+    std::string output;           // CSV path (default stdout)
+    double horizon_years = 25.0;  // stop and report "no decay" beyond this
+    double default_bc_m2_kg = 0.0;// used when B* <= 0 (0 = treat as drag-free)
+    size_t threads = 0;           // 0 = all cores
+};
+
+// Reentry prediction for every TLE in the file. Mean elements advance in
+// steps of whole orbits with orbit-averaged drag and secular J2 rates; the
+// last few days before decay are integrated numerically (J2 + drag).
+// Writes one CSV row per object with the predicted decay epoch.
+bool run_lifetime(const std::string& tle_path, const LifetimeOptions& opt);
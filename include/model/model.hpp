@@ -1,4 +1,6 @@
 #pragma once
 #include "physics/engine.hpp"
 #include "core/output.hpp"
-void run_model(PhysicsEngine& e,double dt,double t_end,OutputWriter* ow);
+#include "sim/checkpoint.hpp"
+void run_model(PhysicsEngine& e,double dt,double t_end,OutputWriter* ow,
+               Checkpointer* cp=nullptr,const Checkpoint* resume=nullptr);
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include "orbit/lambert.hpp"
+#include "physics/engine.hpp"
+#include "sim/scenario.hpp"
+
+struct PorkchopOptions{
+    std::string chaser;             // entity names (default: Ace chases Chat,
+    std::string target;             // i.e. bodies 1 and 0 as in lambert_demo)
+    std::string output;             // CSV path (default stdout)
+    double depart_start_h = 0.0;    // departure window, hours after epoch
+    double depart_end_h = 24.0;
+    double depart_step_h = 1.0;
+    double tof_min_h = 1.0;         // time-of-flight range, hours
+    double tof_max_h = 24.0;
+    double tof_step_h = 0.5;
+    int max_rev = 0;
+    LambertMethod lambert = LAMBERT_IZZO;
+    size_t threads = 0;             // 0 = all cores
+};
+
+// Departure time x time-of-flight grid of Lambert transfers from the chaser
+// to the target. Both orbits follow the secular J2 propagator: the chaser
+// is sampled once over the departure grid and the target once per
+// departure row over its arrival grid, so no cell propagates anything.
+// Rows are solved in parallel. Writes one CSV row per cell with departure,
+// arrival and total delta-v; `min` marks each departure's cheapest TOF
+// ("row") and the overall cheapest cell ("global").
+bool run_porkchop(PhysicsEngine& e, const ScenarioCfg& cfg, const PorkchopOptions& opt);
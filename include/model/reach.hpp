@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+
+struct ReachOptions{
+    std::string chasers;            // comma-separated TLE names
+    std::string output;             // CSV path (default stdout)
+    double start_jd = 0.0;          // departure; 0 = latest TLE epoch
+    double tof_min_h = 1.0;
+    double tof_max_h = 48.0;
+    double tof_step_h = 1.0;
+    double max_dv_m_s = 1000.0;     // reachable if departure + arrival <= this
+    int max_rev = 3;
+    bool warm_start = true;         // seed TOF cells from the previous ones (fine grids)
+    size_t threads = 0;             // 0 = all cores
+};
+
+// Cheapest Lambert rendezvous (departure plus velocity-matching burn) from
+// each chaser to every other TLE object, departing at start_jd, over the
+// TOF window. Pairs whose plane change or altitude change alone exceeds
+// max_dv are dropped before any Lambert solve; the rest are solved in
+// parallel, each pair scanning its TOF cells in order; when the TOF step is
+// a small fraction of an orbit, Householder is warm-started from the
+// previous cells. Orbits follow the secular J2 propagator. Writes the
+// reachable pairs as CSV, per chaser, cheapest first.
+bool run_reach(const std::string& tle_path, const ReachOptions& opt);
@@ -2,4 +2,10 @@
 #include "physics/engine.hpp"
 #include "physics/rocket.hpp"
 #include "core/output.hpp"
-void run_rocket_model(PhysicsEngine& e,double dt,double t_end, OutputWriter* ow);
+#include "sim/checkpoint.hpp"
+#include <iostream>
+// Plans the launch, then flies it; report lines go to log. On return e
+// holds Ace and the rocket (bodies 0 and 1) at the last step.
+void run_rocket_model(PhysicsEngine& e,double dt,double t_end, OutputWriter* ow,
+                      Checkpointer* cp=nullptr,const Checkpoint* resume=nullptr,
+                      std::ostream& log=std::cout);
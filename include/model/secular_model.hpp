@@ -0,0 +1,10 @@
+#pragma once
+#include "physics/engine.hpp"
+#include "core/output.hpp"
+#include <iostream>
+
+// Scenario `propagator secular_j2`: the engine's t=0 states seed a mean
+// element catalog that drifts with J2 secular rates. States are evaluated
+// in closed form at output ticks and hourly reports only; nothing steps.
+// Reports go to log; e holds the states at t_end on return.
+void run_secular_model(PhysicsEngine& e,double t_end,OutputWriter* ow,std::ostream& log=std::cout);
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "physics/engine.hpp"
+#include "sim/scenario.hpp"
+
+struct ServeOptions{
+    std::string endpoint;           // unix:<path> or tcp:<port>
+    double grid_s = 60.0;           // spacing of cached whole-catalog states
+    size_t cache_states = 64;       // cached grid times kept (LRU)
+    size_t max_clients = 64;
+};
+
+// Query daemon: the scenario's t=0 states seed a secular J2 catalog once,
+// then requests are answered from it until SIGINT/SIGTERM. One text line
+// per request; <time> is seconds since the scenario epoch, jd:<Julian
+// date> or now; <name> is the rest of the line.
+//   STATE <time> <name>               catalog object or ephemeris body
+//   NEAREST <time> <n> <name>         n closest catalog objects
+//   WITHIN <time> <radius_km> <name>  catalog objects inside the radius
+//   INFO
+// Reply: "OK <rows>" and that many CSV rows, or "ERR <message>".
+//
+// Range queries screen the whole catalog from cached states on a grid_s
+// grid, extrapolated linearly to <time> with a per-object bound on the
+// error, and propagate exactly only the objects the bound cannot exclude.
+bool run_serve(PhysicsEngine& e, const ScenarioCfg& cfg, const ServeOptions& opt);
+
+// One request against a running server; prints the reply rows to stdout.
+// False (with the server's message) on ERR or if the server is unreachable.
+bool run_query(const std::string& endpoint, const std::string& request);
@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+
+// Parameter sweep over one base scenario. Spec file, one directive per line:
+//   base <scenario>
+//   vary <key> <v1> <v2> ...              (value list)
+//   vary <key> range <start> <stop> <step> (inclusive range)
+//   report <entity>                       (final COE in summary; default first body;
+//                                          must name a body of the base)
+//   summary <path>                        (default stdout)
+//   output_dir <dir>                      (optional per-run CSV)
+//   output_rate <sec>                     (default 60)
+//   threads <n>                           (default all cores)
+// Keys follow apply_scenario_override: timestep_seconds, Leo11.i_deg, ...
+// Variants are the Cartesian product of all `vary` lines. Each runs the
+// base's model and propagator as --model would (rocket, secular_j2, or
+// fixed-step numeric); with output_dir, model reports go to run_<n>.log.
+// lambert_demo bases are rejected.
+bool run_sweep(const std::string& spec_path);
@@ -2,7 +2,10 @@
 #include "physics/engine.hpp"
 #include "sim/scenario.hpp"
 #include "core/output.hpp"
+#include "sim/checkpoint.hpp"
 
 void run_tle_hour_report(PhysicsEngine& e,
                          const ScenarioCfg& cfg,
-                         OutputWriter* ow=nullptr);
+                         OutputWriter* ow=nullptr,
+                         Checkpointer* cp=nullptr,
+                         const Checkpoint* resume=nullptr);
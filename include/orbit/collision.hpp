@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+
+// Short-encounter (2D) probability of collision. At TCA the relative
+// motion is taken as straight and the position uncertainty as fixed, so Pc
+// is the combined position Gaussian integrated over the hard-body disc in
+// the encounter plane (normal to the relative velocity).
+
+struct ConjunctionEvent{
+    double r[3], v[3];      // object 2 relative to object 1 at TCA, ECI (km, km/s)
+    double c1[6], c2[6];    // position covariances, ECI upper triangle xx xy xz yy yz zz (km^2)
+    double hbr_km;          // combined hard-body radius
+};
+
+enum PcMethod{
+    PC_AUTO = 0,            // series where it is accurate, else integration
+    PC_SERIES = 1,          // Chan's equal-area series
+    PC_INTEGRATE = 2,       // 1D quadrature of an erf strip integral
+};
+
+// "auto", "series" or "integrate".
+bool pc_method_from_name(const char* name, PcMethod& out);
+
+struct PcResult{
+    double pc = 0.0;
+    double miss_km = 0.0;
+    double sigma_major_km = 0.0;    // encounter-plane principal axes
+    double sigma_minor_km = 0.0;
+    PcMethod method = PC_AUTO;      // the one actually used
+    bool ok = false;                // false for zero relative velocity or a singular covariance
+};
+
+// Encounter-plane Pc for a disc of radius R centred at (mx, mz) in the
+// principal axes of a Gaussian with sigmas sx, sz.
+double pc_series(double mx, double mz, double sx, double sz, double R);
+double pc_integrate(double mx, double mz, double sx, double sz, double R);
+
+PcResult collision_probability(const ConjunctionEvent& ev, PcMethod method = PC_AUTO);
+
+// n events in parallel on up to `threads` workers (0 = all cores).
+void collision_probability_batch(size_t n, const ConjunctionEvent* ev, PcResult* out,
+                                 PcMethod method = PC_AUTO, size_t threads = 0);
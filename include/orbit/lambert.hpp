@@ -1,7 +1,16 @@
 #pragma once
 #include <array>
+#include <string>
 #include <vector>
 
+enum LambertMethod : int {
+    LAMBERT_UNIVERSAL = 0,  // universal variable, bracket + bisection in z
+    LAMBERT_IZZO = 1,       // Izzo 2015, Householder iterations
+};
+
+// "uv" or "izzo".
+bool lambert_method_from_name(const std::string& name, LambertMethod& m);
+
 struct LambertSolution{
     std::array<double,3> v1_km_s;
     std::array<double,3> v2_km_s;
@@ -12,12 +21,52 @@ struct NMCParams{
     double entry_angle_deg; // degrees
 };
 
+// The single-revolution solution, then left and right branches for each
+// feasible revolution up to max_rev; both methods return the same
+// solutions in the same order. Empty when r1 and r2 are 0 or 180 deg
+// apart. Transfers are prograde about +z unless retrograde.
 std::vector<LambertSolution>
 lambert_intercept(const std::array<double,3>& r1,
                   const std::array<double,3>& r2,
                   double tof_s,
                   double mu_km3_s2,
-                  int max_rev);
+                  int max_rev,
+                  LambertMethod method = LAMBERT_IZZO,
+                  bool retrograde = false);
+
+// Revolution count of the index-th solution returned by lambert_intercept.
+inline int lambert_revolutions(size_t index){
+    return (int)(index + 1)/2;
+}
+
+// Householder seeds carried along a uniform sequence of solves: x per
+// branch (in return order) from the last two, extrapolated linearly, and
+// the iterations the last solve took.
+struct LambertWarmStart{
+    std::vector<double> x, x_prev;
+    int iterations = 0;
+};
+
+std::vector<LambertSolution>
+lambert_izzo(const std::array<double,3>& r1,
+             const std::array<double,3>& r2,
+             double tof_s,
+             double mu_km3_s2,
+             int max_rev,
+             bool retrograde = false,
+             LambertWarmStart* warm = nullptr);
+
+// Solution with the smallest departure burn |v1 - v_now|; NaN velocities
+// when sols is empty.
+LambertSolution pick_min_dv1(const std::vector<LambertSolution>& sols,
+                             const std::array<double,3>& v_now_km_s);
+
+// Index of the solution with the smallest |v1 - v_now| + |v_target - v2|
+// (departure plus matching burn); sols.size() when none is finite.
+size_t pick_min_dv_total(const std::vector<LambertSolution>& sols,
+                         const std::array<double,3>& v_now_km_s,
+                         const std::array<double,3>& v_target_km_s,
+                         double& dv1_km_s, double& dv2_km_s);
 
 std::vector<LambertSolution>
 lambert_rendezvous(const std::array<double,3>& r1,
@@ -25,7 +74,8 @@ lambert_rendezvous(const std::array<double,3>& r1,
                    const std::array<double,3>& r2,
                    double tof_s,
                    double mu_km3_s2,
-                   int max_rev);
+                   int max_rev,
+                   LambertMethod method = LAMBERT_IZZO);
 
 std::vector<LambertSolution>
 lambert_nmc(const std::array<double,3>& r1,
@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+// Relative motion about a target in its rotating RIC frame: R radial,
+// I in-track, C along the orbit normal. Relative states are
+// (x, y, z, xdot, ydot, zdot) in km and km/s, rates taken in the rotating
+// frame.
+
+struct RicFrame{
+    std::array<double,3> r, v;          // target ECI state
+    std::array<double,3> eR, eI, eC;
+    double w = 0.0;                     // frame rotation |h|/r^2, rad/s
+    double n = 0.0;                     // mean motion, rad/s
+    double e = 0.0;                     // target eccentricity
+    double rmag = 0.0;
+};
+
+RicFrame ric_frame(const std::array<double,3>& r, const std::array<double,3>& v, double mu_km3_s2);
+
+void eci_to_ric(const RicFrame& f, const std::array<double,3>& r, const std::array<double,3>& v,
+                double rel[6]);
+void ric_to_eci(const RicFrame& f, const double rel[6],
+                std::array<double,3>& r, std::array<double,3>& v);
+
+// Clohessy-Wiltshire state transition over t for mean motion n.
+void cw_stm(double n, double t, double phi[6][6]);
+void cw_propagate(double n, double t, const double in[6], double out[6]);
+// m relative states (6 doubles each) advanced by the same t: one STM.
+void cw_propagate_batch(double n, double t, size_t m, const double* in, double* out);
+
+// Largest range a CW trajectory from rel reaches within [0, t]: guiding
+// centre drift plus the 2:1 ellipse and cross-track amplitudes.
+double cw_range_bound_km(double n, const double rel[6], double t);
+
+// Estimated position error (km) of CW over t for a chaser whose range
+// stays within rho_max_km (cw_range_bound_km): the quadratic gravity term CW drops grows as
+// 1.5 (rho/r) (n t)^2 rho, and target eccentricity adds about
+// 3 e (1 + n t) rho.
+double cw_error_bound_km(const RicFrame& f, double rho_max_km, double t);
+
+// Two-body Kepler propagation by Lagrange f and g; false unless the orbit
+// is an ellipse.
+bool kepler_propagate(const std::array<double,3>& r0, const std::array<double,3>& v0,
+                      double dt, double mu_km3_s2,
+                      std::array<double,3>& r, std::array<double,3>& v);
+
+// CW for all m chasers, except those whose error bound exceeds tol_km:
+// those are propagated in ECI with the target (two-body) and re-expressed
+// in the target's frame at t. Returns how many fell back.
+size_t relative_propagate(const RicFrame& f, double t, size_t m, const double* in, double* out,
+                          double tol_km, double mu_km3_s2);
+
+// Drift-free natural-motion circumnavigation: a 2:1 ellipse with radial
+// semi-axis b_km centred on the target, entered at phase theta (rad) at
+// (b cos theta, 2 b sin theta, 0).
+void cw_nmc_state(double b_km, double theta, double n, double rel[6]);
@@ -1,2 +1,33 @@
 #pragma once
+#include <cmath>
+#include <cstddef>
+
+// Density in kg/m^3 from a piecewise-exponential model (standard-atmosphere
+// bands, 0-1000 km), tabulated at 1 km and linearly interpolated. Zero at
+// and above the top of the table.
 double air_density(double alt_m);
+
+static constexpr double ATMOSPHERE_TOP_KM = 1000.0;
+
+// Batch lookup: rho[i] = density at alt_km[i], identical to air_density.
+// Branch-free over the table.
+void air_density_batch(size_t n, const double* alt_km, double* rho);
+
+// Ballistic drag in km units: a = -1/2 rho (Cd A / m) |v_rel| v_rel with
+// v_rel = v - w_E x r (co-rotating atmosphere). bc_m2_kg = Cd*A/m.
+// Adds km/s^2 to a*.
+inline void drag_accel(double rho, double bc_m2_kg,
+                       double x, double y,
+                       double vx, double vy, double vz,
+                       double& ax, double& ay, double& az){
+    constexpr double OMEGA_E_RAD_S = 7.2921159e-5;
+    const double rx = vx + OMEGA_E_RAD_S*y;
+    const double ry = vy - OMEGA_E_RAD_S*x;
+    const double rz = vz;
+    const double v = std::sqrt(rx*rx + ry*ry + rz*rz);
+    // rho [kg/m^3] * bc [m^2/kg] * v^2 [km^2/s^2] = 1/m * km^2/s^2 = 1e3 km/s^2
+    const double k = -0.5 * rho * bc_m2_kg * v * 1000.0;
+    ax += k*rx;
+    ay += k*ry;
+    az += k*rz;
+}
@@ -1,6 +1,13 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
+#include "physics/gravity.hpp"
+
+class Ephemeris;
+struct ForceModel;
+class StatePublisher;
 
 struct Body{
     double x=0,y=0,z=0;
@@ -8,11 +15,92 @@ struct Body{
     double mass=0;
 };
 
+// Per-body surface properties for non-gravitational forces.
+struct BodySurface{
+    double area_m2=0.0;
+    double cd=2.2;
+    double cr=1.3;   // radiation pressure coefficient (1 absorbing .. 2 mirror)
+};
+
+// Point-mass perturber whose position comes from the engine ephemeris.
+struct ThirdBody{
+    int eph_index=-1;
+    double mu_km3_s2=0.0;
+};
+
 class PhysicsEngine{
 public:
     std::vector<Body> bodies;
     std::vector<std::string> names;
 
+    // Environment-body ephemeris for the run window (optional).
+    std::shared_ptr<const Ephemeris> ephemeris;
+
+    // Seconds since scenario epoch; advanced by step().
+    double time=0.0;
+    double epoch_jd=2451545.0;
+
+    // Non-central Earth gravity (degree 0 = point mass only).
+    GravityField gravity;
+
+    // Luni-solar (or any ephemeris body) differential gravity.
+    std::vector<ThirdBody> third_bodies;
+
+    // Parallel to bodies when present; missing entries mean zero area.
+    std::vector<BodySurface> surfaces;
+
+    // When set, every completed step is published to its readers.
+    StatePublisher* publisher=nullptr;
+
     void add(const Body& b,const std::string& name);
     void step(double dt);
+
+    // Adds the named ephemeris bodies as perturbers (GM from Environment mass).
+    bool enable_third_body(const std::vector<std::string>& perturbers);
+    bool set_gravity(int degree,int order);
+
+    // Atmospheric drag on every body with area and mass; rebuilds the
+    // drag set (and ballistic coefficients) from surfaces and masses, so
+    // call again after changing them.
+    void set_drag(bool on);
+    size_t drag_count() const { return drag_index.size(); }
+
+    // Cannonball solar radiation pressure, same body selection as drag.
+    void set_srp(bool on);
+    size_t srp_count() const { return srp_index.size(); }
+
+    // Feature bits of the current configuration and the pipeline chosen for
+    // them (re-selected whenever gravity or perturbers change).
+    unsigned force_features() const;
+    const ForceModel* force_model() const { return model; }
+    bool use_force_model(const ForceModel* m);
+
+private:
+    template<class,class...> friend struct ForcePipeline;
+    friend struct HarmonicsGravity;
+    friend struct DragForce;
+    friend struct SrpForce;
+
+    void select_force_model();
+    const ForceModel* model=nullptr;
+
+    void accumulate_harmonics(size_t n);
+    void accumulate_drag();
+    void accumulate_srp();
+
+    bool drag=false;
+    std::vector<uint32_t> drag_index;
+    std::vector<double> drag_bc, drag_alt, drag_rho; // bc = Cd*A/m (m^2/kg)
+
+    bool srp=false;
+    std::vector<uint32_t> srp_index;
+    std::vector<double> srp_k;       // P * Cr * A/m at 1 AU (km/s^2)
+    std::vector<double> srp_pos;     // gathered positions, stride 3
+    std::vector<double> srp_nu;      // sunlit fraction
+    std::vector<unsigned char> srp_shadow;
+
+    // Per-step acceleration scratch, SoA (km/s^2), plus Earth-fixed
+    // positions/accelerations for tesseral fields.
+    std::vector<double> ax, ay, az;
+    std::vector<double> fx, fy, fz, fax, fay, faz;
 };
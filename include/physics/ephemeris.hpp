@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <string>
+#include <vector>
+
+// Low-precision analytic series, geocentric equatorial km.
+std::array<double,3> moon_eci_km(double jd);
+// Any environment body (Sun, Moon, planets, Galilean moons); false if unknown.
+bool analytic_body_eci_km(const std::string& name,double jd,std::array<double,3>& out);
+
+// Piecewise Chebyshev ephemeris for the environment bodies over a run
+// window. Times are seconds since epoch_jd(). Positions km, velocities km/s.
+// Evaluation outside the fitted window extrapolates the edge segment.
+class Ephemeris{
+public:
+    // Fit every known body from the analytic series over [jd0, jd0+span_s].
+    void fit_analytic(double jd0,double span_s);
+
+    // Text coefficient file (written by save, or converted from external data).
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    double epoch_jd() const { return jd0; }
+    double span_s() const { return span; }
+    size_t size() const { return series.size(); }
+    const std::string& name(size_t i) const { return series[i].name; }
+    int index(const std::string& name) const;
+
+    std::array<double,3> position(int body,double t_s) const;
+    void state(int body,double t_s,double r_km[3],double v_km_s[3]) const;
+
+private:
+    struct Series{
+        std::string name;
+        double seg_s=0.0;
+        int n=0;                 // coefficients per axis (degree+1)
+        size_t n_seg=0;
+        std::vector<double> c;   // [(seg*3+axis)*n + k]
+        std::vector<double> dc;  // derivative series, same layout, per second
+    };
+
+    const double* segment(const Series& s,double t_s,double& x) const;
+
+    double jd0=2451545.0;
+    double span=0.0;
+    std::vector<Series> series;
+};
+
+// Moves every Environment entity known to the ephemeris to its state at t_s.
+void refresh_environment(const Ephemeris& eph,double t_s);
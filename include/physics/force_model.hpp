@@ -0,0 +1,155 @@
+#pragma once
+#include "physics/engine.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/gravity.hpp"
+#include "physics/atmosphere.hpp"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+// Compile-time force/integrator pipeline. A force term is a small policy
+// type: prepare() runs once per step, add() is inlined into the per-body
+// loop. Terms that only exist as batch kernels (batch == true) accumulate
+// into the engine's SoA scratch before the fused loop instead.
+
+enum ForceFeature : unsigned {
+    FORCE_J2         = 1u<<0,
+    FORCE_HARMONICS  = 1u<<1,  // general field (degree > 2 or tesseral)
+    FORCE_THIRD_BODY = 1u<<2,
+    FORCE_DRAG       = 1u<<3,
+    FORCE_SRP        = 1u<<4,
+};
+
+struct CentralGravity{
+    static constexpr bool batch=false;
+    static constexpr double MU_KM3_S2 = 398600.4418;
+    void prepare(const PhysicsEngine&){}
+    void add(const Body& b,double& ax,double& ay,double& az) const {
+        const double r2 = b.x*b.x + b.y*b.y + b.z*b.z;
+        const double r  = std::sqrt(std::max(1e-12, r2));
+        const double inv_r3 = 1.0/(r*r*r);
+        ax += -MU_KM3_S2 * b.x * inv_r3;
+        ay += -MU_KM3_S2 * b.y * inv_r3;
+        az += -MU_KM3_S2 * b.z * inv_r3;
+    }
+};
+
+struct J2Gravity{
+    static constexpr bool batch=false;
+    double k=0.0;
+    void prepare(const PhysicsEngine& e){ k = j2_coefficient(e.gravity); }
+    void add(const Body& b,double& ax,double& ay,double& az) const {
+        j2_accel(k, b.x, b.y, b.z, ax, ay, az);
+    }
+};
+
+struct HarmonicsGravity{
+    static constexpr bool batch=true;
+    void prepare(const PhysicsEngine&){}
+    void accumulate(PhysicsEngine& e,size_t n) const { e.accumulate_harmonics(n); }
+};
+
+struct DragForce{
+    static constexpr bool batch=true;
+    void prepare(const PhysicsEngine&){}
+    void accumulate(PhysicsEngine& e,size_t) const { e.accumulate_drag(); }
+};
+
+struct SrpForce{
+    static constexpr bool batch=true;
+    void prepare(const PhysicsEngine&){}
+    void accumulate(PhysicsEngine& e,size_t) const { e.accumulate_srp(); }
+};
+
+// a = mu * ( (s - r)/|s - r|^3 - s/|s|^3 ) per perturber; the perturber
+// position and its indirect term are evaluated once per step.
+struct ThirdBodyGravity{
+    static constexpr bool batch=false;
+    static constexpr size_t MAX_PERTURBERS = 4;
+    struct Term{ double sx, sy, sz, mu, ix, iy, iz; };
+    Term terms[MAX_PERTURBERS];
+    size_t count=0;
+
+    void prepare(const PhysicsEngine& e){
+        count = std::min(e.third_bodies.size(), MAX_PERTURBERS);
+        for(size_t j=0;j<count;j++){
+            const auto& tb = e.third_bodies[j];
+            const auto s = e.ephemeris->position(tb.eph_index, e.time);
+            const double s2 = s[0]*s[0] + s[1]*s[1] + s[2]*s[2];
+            const double ks = tb.mu_km3_s2/(s2*std::sqrt(s2));
+            terms[j] = {s[0], s[1], s[2], tb.mu_km3_s2, -ks*s[0], -ks*s[1], -ks*s[2]};
+        }
+    }
+    void add(const Body& b,double& ax,double& ay,double& az) const {
+        for(size_t j=0;j<count;j++){
+            const Term& t = terms[j];
+            const double dx = t.sx - b.x;
+            const double dy = t.sy - b.y;
+            const double dz = t.sz - b.z;
+            const double d2 = dx*dx + dy*dy + dz*dz;
+            const double k  = t.mu/(d2*std::sqrt(d2));
+            ax += k*dx + t.ix;
+            ay += k*dy + t.iy;
+            az += k*dz + t.iz;
+        }
+    }
+};
+
+struct SemiImplicitEuler{
+    static void advance(Body& b,double ax,double ay,double az,double dt){
+        b.vx += ax*dt; b.vy += ay*dt; b.vz += az*dt;
+        b.x  += b.vx*dt; b.y  += b.vy*dt; b.z  += b.vz*dt;
+    }
+};
+
+template<class Integrator,class... Forces>
+struct ForcePipeline{
+    static constexpr bool HAS_BATCH = (Forces::batch || ...);
+
+    static void step(PhysicsEngine& e,double dt){
+        const size_t n = e.bodies.size();
+        if(n==0) return;
+
+        std::tuple<Forces...> forces;
+        std::apply([&](auto&... f){ (f.prepare(e), ...); }, forces);
+
+        if constexpr(HAS_BATCH){
+            e.ax.assign(n, 0.0); e.ay.assign(n, 0.0); e.az.assign(n, 0.0);
+            std::apply([&](auto&... f){ (accumulate_batch(f, e, n), ...); }, forces);
+        }
+
+        Body* __restrict bp = e.bodies.data();
+        for(size_t i=0;i<n;i++){
+            Body& b = bp[i];
+            // -0.0 is the additive identity, so a lone term folds to a store.
+            double ax=-0.0, ay=-0.0, az=-0.0;
+            if constexpr(HAS_BATCH){ ax = e.ax[i]; ay = e.ay[i]; az = e.az[i]; }
+            std::apply([&](const auto&... f){ (add_inline(f, b, ax, ay, az), ...); }, forces);
+            Integrator::advance(b, ax, ay, az, dt);
+        }
+        e.time += dt;
+    }
+
+private:
+    template<class F>
+    static void accumulate_batch(const F& f,PhysicsEngine& e,size_t n){
+        if constexpr(F::batch) f.accumulate(e, n);
+    }
+    template<class F>
+    static void add_inline(const F& f,const Body& b,double& ax,double& ay,double& az){
+        if constexpr(!F::batch) f.add(b, ax, ay, az);
+    }
+};
+
+// Pre-instantiated pipelines, one per supported feature set.
+struct ForceModel{
+    const char* name;
+    unsigned features;
+    void (*step)(PhysicsEngine&,double);
+};
+
+const std::vector<ForceModel>& force_models();
+
+// Exact feature-set match; nullptr if no instantiation covers it.
+const ForceModel* find_force_model(unsigned features);
@@ -0,0 +1,47 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Earth spherical-harmonic field (EGM96, up to degree/order 6), stored
+// unnormalized for the Cunningham V/W recursion.
+struct GravityField{
+    int degree=0;
+    int order=0;
+    double mu_km3_s2=398600.4415;
+    double re_km=6378.1363;
+    std::vector<double> C, S; // [n*(n+1)/2 + m], n<=degree, m<=min(n,order)
+
+    bool zonal_only() const { return order==0; }
+    bool j2_only() const { return degree==2 && order==0; }
+    double c(int n,int m) const { return C[(size_t)(n*(n+1)/2+m)]; }
+    double s(int n,int m) const { return S[(size_t)(n*(n+1)/2+m)]; }
+};
+
+static constexpr int GRAVITY_MAX_DEGREE = 6;
+
+// False if degree/order are out of range (degree 2..6, order 0..degree).
+bool make_earth_gravity(int degree,int order,GravityField& out);
+
+// Adds the non-central (n>=2) acceleration for n positions given in the
+// Earth-fixed frame (km) to a* (km/s^2). Bodies are processed in blocks
+// of fixed lane width so the recursion runs across lanes.
+void harmonics_accel_batch(const GravityField& g,size_t n,
+                           const double* x,const double* y,const double* z,
+                           double* ax,double* ay,double* az);
+
+// Closed-form J2 acceleration for one position; k = 1.5*J2*mu*Re^2.
+inline void j2_accel(double k,double x,double y,double z,double& ax,double& ay,double& az){
+    const double r2=x*x+y*y+z*z;
+    const double inv_r2=1.0/r2;
+    const double inv_r5=inv_r2*inv_r2/std::sqrt(r2);
+    const double z2=5.0*z*z*inv_r2;
+    const double f=-k*inv_r5;
+    ax+=f*x*(1.0-z2);
+    ay+=f*y*(1.0-z2);
+    az+=f*z*(3.0-z2);
+}
+
+inline double j2_coefficient(const GravityField& g){
+    return -1.5*g.c(2,0)*g.mu_km3_s2*g.re_km*g.re_km;
+}
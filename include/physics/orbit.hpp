@@ -3,3 +3,8 @@
 struct COE { double a,e,i,raan,argp,ta; }; // a km, angles rad
 Body coe_to_body_eci(const COE&);
 COE body_to_coe_eci(const Body&);
+
+// Elliptic Kepler's equation: true anomaly from mean anomaly (Newton to
+// 1e-13 rad) and back. Angles rad.
+double true_from_mean(double M, double e);
+double mean_from_true(double ta, double e);
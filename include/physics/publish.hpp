@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/triple_buffer.hpp"
+#include "physics/engine.hpp"
+
+// One completed step: engine time plus every body.
+struct StateSnapshot{
+    uint64_t seq = 0;               // publish count; 0 = nothing yet
+    double time = 0.0;
+    double epoch_jd = 0.0;
+    std::vector<Body> bodies;
+    std::vector<std::string> names;
+};
+
+// Publishes engine state to concurrent readers without locks. Each reader
+// owns a triple buffer, so the stepping thread never waits on a reader and
+// readers never wait on it or each other; snapshot storage is reused, and
+// names are copied only when the body count changes.
+class StatePublisher{
+public:
+    // Register every reader before stepping starts; returns its id.
+    size_t add_reader();
+    size_t reader_count() const { return readers.size(); }
+
+    // Stepping thread.
+    void publish(const PhysicsEngine& e);
+
+    // Reader `id` only: its newest snapshot (seq 0 before the first
+    // publish). Stays valid and unchanged until that reader calls again.
+    const StateSnapshot& latest(size_t id);
+
+private:
+    std::vector<std::unique_ptr<TripleBuffer<StateSnapshot>>> readers;
+    uint64_t seq = 0;
+};
@@ -15,12 +15,24 @@ struct RocketState{
     double mass=0;          // kg
 };
 
+// Complete internal state, for checkpoint/restart.
+struct RocketCheckpoint{
+    std::vector<Stage> stages;
+    size_t cur=0;
+    double fuel=0.0, dry=0.0, mass=0.0;
+    RocketState s{};
+    bool sep=false, powered=false, is_dead=false;
+};
+
 class Rocket{
 public:
     Rocket()=default;
     Rocket(const std::vector<Stage>& stages);
 
     void set_state(const RocketState& s);
+
+    // Reference area and drag coefficient; area 0 disables drag.
+    void set_aero(double area_m2, double cd){ aero_area_m2=area_m2; aero_cd=cd; }
     RocketState state() const;
 
     // Two-body + thrust in km-space (mu in km^3/s^2).
@@ -39,6 +51,9 @@ public:
     bool has_thrust() const { return powered; }
     bool dead() const { return is_dead; }
 
+    RocketCheckpoint checkpoint() const;
+    void restore(const RocketCheckpoint& c);
+
 private:
     double mdot() const;
 
@@ -56,6 +71,9 @@ private:
     bool sep=false;
     bool powered=false;
 
+    double aero_area_m2=0.0;
+    double aero_cd=0.0;
+
     // rocket.cpp still references this
     bool is_dead=false;
 };
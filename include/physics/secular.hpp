@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "physics/engine.hpp"
+#include "physics/orbit.hpp"
+
+// Closed-form J2 secular rates (rad/s) of node, perigee and mean anomaly
+// for mean elements a (km), e, i (rad).
+void j2_secular_rates(double a, double e, double i,
+                      double& raan_dot, double& argp_dot, double& M_dot);
+
+// Mean-element catalog advanced analytically: elements at t are the epoch
+// elements plus secular J2 drift, so a state costs O(1) per body whatever
+// the horizon. Stored SoA so states_at() runs one tight loop per output.
+class SecularCatalog{
+public:
+    size_t size() const { return a.size(); }
+    void reserve(size_t n);
+
+    // COE with true anomaly, valid at t_epoch (catalog time, s).
+    void add(const COE& c, double mass, double t_epoch = 0.0);
+    // Osculating Cartesian state at t=0 taken as mean elements.
+    void add(const Body& b);
+
+    // ECI states at t seconds; writes x..vz of out[0..size()), keeps mass.
+    void states_at(double t, Body* out) const;
+    // Single-body state at t.
+    void state_at(size_t k, double t, Body& out) const;
+    // Single-body states at t0 + i*dt, i < m: Kepler warm-started from the
+    // previous sample and node/perigee advanced by rotation, several times
+    // cheaper per sample than state_at.
+    void states_on_grid(size_t k, double t0, double dt, size_t m, Body* out) const;
+
+    // Mean elements at t (ta = true anomaly).
+    COE elements_at(size_t k, double t) const;
+
+private:
+    std::vector<double> a, e, inc, raan0, argp0, M0;
+    std::vector<double> raan_dot, argp_dot, M_dot;
+    // per-body constants of the closed-form state
+    std::vector<double> sq1me2, sqrt_mu_a, ci, si, mass;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Conical Earth shadow (Montenbruck & Gill 3.4). Seen from the satellite,
+// a = apparent Sun radius, b = apparent Earth radius, c = their separation:
+// penumbra while c < a + b, umbra while c < b - a.
+
+static constexpr double SHADOW_R_SUN_KM = 695700.0;
+static constexpr double SHADOW_R_EARTH_KM = 6378.137;
+
+enum ShadowState : unsigned char {
+    SHADOW_NONE     = 0,
+    SHADOW_PENUMBRA = 1,
+    SHADOW_UMBRA    = 2,
+};
+
+// Boundary margins without inverse trig: pen = cos c - cos(a+b) and
+// umb = cos c - cos(b-a), positive inside. r, sun: Earth-centred km.
+inline void shadow_margins(double rx, double ry, double rz, const double sun[3],
+                           double& pen, double& umb){
+    const double dx = sun[0] - rx, dy = sun[1] - ry, dz = sun[2] - rz;
+    const double d = std::sqrt(dx*dx + dy*dy + dz*dz);
+    const double r = std::sqrt(rx*rx + ry*ry + rz*rz);
+    const double sa = SHADOW_R_SUN_KM/d, ca = std::sqrt(1.0 - sa*sa);
+    const double sb = std::min(1.0, SHADOW_R_EARTH_KM/r), cb = std::sqrt(1.0 - sb*sb);
+    const double cc = -(rx*dx + ry*dy + rz*dz)/(r*d);
+    pen = cc - (ca*cb - sa*sb);
+    umb = sb > sa ? cc - (ca*cb + sa*sb) : -2.0;
+}
+
+inline ShadowState shadow_state(double rx, double ry, double rz, const double sun[3]){
+    double pen, umb;
+    shadow_margins(rx, ry, rz, sun, pen, umb);
+    return umb > 0.0 ? SHADOW_UMBRA : pen > 0.0 ? SHADOW_PENUMBRA : SHADOW_NONE;
+}
+
+// Fraction of the solar disc visible from r: 1 sunlit, 0 in umbra, and in
+// the penumbra one minus the overlap of the two discs (M&G eq. 3.87).
+inline double sunlight_fraction(double rx, double ry, double rz, const double sun[3]){
+    double pen, umb;
+    shadow_margins(rx, ry, rz, sun, pen, umb);
+    if(pen <= 0.0) return 1.0;
+    if(umb > 0.0) return 0.0;
+    const double dx = sun[0] - rx, dy = sun[1] - ry, dz = sun[2] - rz;
+    const double d = std::sqrt(dx*dx + dy*dy + dz*dz);
+    const double r = std::sqrt(rx*rx + ry*ry + rz*rz);
+    const double a = std::asin(SHADOW_R_SUN_KM/d);
+    const double b = std::asin(std::min(1.0, SHADOW_R_EARTH_KM/r));
+    const double c = std::acos(std::clamp(-(rx*dx + ry*dy + rz*dz)/(r*d), -1.0, 1.0));
+    if(c < a - b) return 1.0 - (b*b)/(a*a);  // annular: Earth disc inside the Sun's
+    const double x = (c*c + a*a - b*b)/(2.0*c);
+    const double y = std::sqrt(std::max(0.0, a*a - x*x));
+    const double overlap = a*a*std::acos(std::clamp(x/a, -1.0, 1.0))
+                         + b*b*std::acos(std::clamp((c - x)/b, -1.0, 1.0)) - c*y;
+    return std::clamp(1.0 - overlap/(M_PI*a*a), 0.0, 1.0);
+}
+
+// States for n positions read with a stride in doubles (Body records: 7).
+// An arithmetic-only pre-pass (one dot product against the Sun direction)
+// keeps bodies inside a widened penumbra cone; only those get the full
+// conical geometry. Returns how many did.
+size_t shadow_batch(size_t n, const double* xyz, size_t stride, const double sun[3],
+                  unsigned char* state);
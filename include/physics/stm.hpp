@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "physics/engine.hpp"
+
+// Bodies advanced together with their 6x6 state transition matrices
+// d(state(t))/d(state(0)), state = (x, y, z, vx, vy, vz), under central
+// gravity plus J2 with the engine's semi-implicit Euler step. The STM is
+// the exact Jacobian of that discrete step, so corrections built from it
+// converge on the propagated trajectory itself. Stored SoA: states and
+// each of the 36 STM entries are one array across bodies, so every update
+// is a unit-stride loop.
+class StmPropagator{
+public:
+    // j2_k as from j2_coefficient(); 0 = point mass.
+    explicit StmPropagator(double j2_k = 0.0);
+
+    size_t size() const { return x.size(); }
+    double time() const { return t; }
+
+    // Loads the states, STMs set to identity, time to 0.
+    void reset(const Body* b, size_t n);
+    void step(double dt);
+    // Fixed steps of dt up to t_end, the last one shortened to land on it.
+    void propagate(double t_end, double dt);
+
+    Body state(size_t i) const;
+    void stm(size_t i, double phi[6][6]) const;
+
+private:
+    double j2_k;
+    double t = 0.0;
+    std::vector<double> x, y, z, vx, vy, vz, mass;
+    std::vector<double> phi;                      // entry (r,c) at [(6r+c)*n + i]
+    std::vector<double> ax, ay, az;               // step scratch
+    std::vector<double> gxx, gxy, gxz, gyy, gyz, gzz;   // acceleration gradient
+};
+
+// P = phi P0 phi^T.
+void propagate_covariance(const double phi[6][6], const double p0[6][6], double p[6][6]);
+
+// First-order velocity change at the start that moves the position at the
+// end of the STM's span by miss (km): solves phi_rv dv = miss. False if
+// phi_rv is singular (e.g. a half-revolution transfer).
+bool correct_velocity(const double phi[6][6], const double miss[3], double dv[3]);
+
+// Shooting on b0's velocity so that it reaches r_target after tof under
+// the StmPropagator model: one propagation and one correction per
+// iteration. Returns the corrections applied, or -1 if the miss did not drop
+// below tol_km within max_iter; b0 keeps the last velocity tried.
+int target_position(Body& b0, const std::array<double,3>& r_target, double tof, double dt,
+                    double j2_k, double tol_km, int max_iter = 10);
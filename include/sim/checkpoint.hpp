@@ -0,0 +1,73 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "physics/engine.hpp"
+#include "physics/rocket.hpp"
+#include "core/output.hpp"
+
+// Everything needed to continue a run bit-exactly. `t` is the next loop
+// time the model will execute; model_state holds loop-local scalars that
+// a given model needs (planner choice, running minima, ...).
+struct Checkpoint{
+    double t=0.0;
+    double dt=0.0;
+    double t_end=0.0;
+    double engine_time=0.0;
+    std::vector<Body> bodies;
+    std::vector<std::string> names;
+
+    bool has_rocket=false;
+    RocketCheckpoint rocket;
+
+    std::vector<double> model_state;
+
+    bool has_output=false;
+    double output_next_t=0.0;
+    uint64_t output_offset=0;
+};
+
+// Copies engine bodies/names and the output writer position; the caller
+// fills rocket and model_state as needed.
+Checkpoint capture_checkpoint(const PhysicsEngine& e,double t_next,double dt,double t_end,OutputWriter* ow);
+
+// Writes to <path>.tmp, fsyncs and renames over <path>.
+bool save_checkpoint(const std::string& path,const Checkpoint& c);
+bool load_checkpoint(const std::string& path,Checkpoint& c);
+
+// Periodic checkpointing to <dir>/latest.ckpt. The stepping thread only
+// copies state into a Checkpoint and hands it over; serialization and I/O
+// run on a background thread. If a write is still in flight when the next
+// one is submitted, the older pending snapshot is replaced.
+class Checkpointer{
+public:
+    Checkpointer()=default;
+    ~Checkpointer();
+    Checkpointer(const Checkpointer&)=delete;
+    Checkpointer& operator=(const Checkpointer&)=delete;
+
+    void open(const std::string& dir,double every_s,double t_start=0.0);
+    bool enabled() const { return is_on; }
+    bool due(double t) const { return is_on && t+1e-9 >= next_t; }
+    // t is the loop time just completed; schedules the next checkpoint after it.
+    void submit(double t,Checkpoint&& c);
+    void finish();
+
+private:
+    void run();
+
+    std::string path;
+    double every=0.0;
+    double next_t=0.0;
+    bool is_on=false;
+
+    std::thread worker;
+    std::mutex m;
+    std::condition_variable cv;
+    Checkpoint pending;
+    bool has_pending=false;
+    bool stop=false;
+};
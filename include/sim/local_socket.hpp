@@ -0,0 +1,13 @@
+#pragma once
+#include <string>
+
+// Local stream sockets for the live interfaces. Endpoints are
+// "unix:<path>" or "tcp:<port>"; TCP binds and connects to 127.0.0.1 only.
+
+// Non-blocking listening socket; `unix_path` receives the socket path (to
+// unlink on shutdown) or is cleared for TCP. -1, with a message naming
+// `who`, if the endpoint is malformed or cannot be bound.
+int local_listen(const std::string& endpoint, std::string& unix_path, const char* who);
+
+// Connected, blocking socket for a client of `endpoint`; -1 on failure.
+int local_connect(const std::string& endpoint);
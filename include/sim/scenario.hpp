@@ -1,10 +1,88 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
 #include "physics/engine.hpp"
+#include "physics/orbit.hpp"
+
+enum Propagator : int {
+    PROPAGATOR_NUMERIC = 0,     // force pipeline, fixed timestep
+    PROPAGATOR_SECULAR_J2 = 1,  // mean elements + J2 secular drift, output times only
+};
+
+// Which driver `--model` runs (scenario key `model`).
+enum ScenarioModel : int {
+    MODEL_ORBIT = 0,            // generic stepping run
+    MODEL_TLE_HOUR = 1,         // hourly catalog report
+    MODEL_ROCKET = 2,           // rocket ascent and transfer planner
+    MODEL_LAMBERT_DEMO = 3,     // Lambert intercept/rendezvous cases
+};
 
 struct ScenarioCfg{
     double dt=1.0;
     double t_end=0.0;
+    double epoch_jd=2451545.0; // scenario t=0 (UTC Julian date)
+
+    int propagator=PROPAGATOR_NUMERIC;
+    int model=MODEL_ORBIT;     // default: MODEL_ROCKET if there is a rocket entity
+
+    // Force model switches
+    bool third_body=false;     // Sun + Moon point-mass perturbations
+    int gravity_degree=0;      // spherical harmonics (0 = point mass, 2..6)
+    int gravity_order=0;
+    bool drag=false;           // atmospheric drag on bodies with area and mass
+    bool srp=false;            // solar radiation pressure on the same bodies
+
+    // Surface defaults for TLE catalog bodies (area 0 = no drag).
+    double catalog_mass_kg=0.0;
+    double catalog_area_m2=0.0;
+    double catalog_cd=2.2;
+    double catalog_cr=1.3;
+};
+
+// One `entity` block as written in the scenario (COE angles in radians).
+struct ScenarioEntity{
+    std::string name;
+    std::string type;
+    COE coe{};
+    bool has_coe=false;
+
+    // Drag/SRP surface (satellites: mass_kg overrides the default body mass)
+    double mass_kg=0.0;
+    double area_m2=0.0;
+    double cd=2.2;
+    double cr=1.3;
+
+    // Rocket launch params (degrees in scenario file)
+    double launch_lat_deg = 0.0;
+    double launch_lon_deg = 0.0;
+    double launch_az_deg  = 90.0;
+    bool has_launch = false;
 };
 
+// TLE catalog converted to ECI once at parse time.
+struct ScenarioCatalog{
+    std::vector<Body> bodies;
+    std::vector<std::string> names;
+};
+
+// Parsed scenario. Copies share the read-only catalog, so one parse can
+// seed many engines (sweeps) without re-reading or re-converting TLEs.
+struct ScenarioDef{
+    ScenarioCfg cfg;
+    std::vector<ScenarioEntity> ents;
+    std::string tle_path;
+    std::shared_ptr<const ScenarioCatalog> catalog;
+};
+
+bool parse_scenario(const std::string& path,ScenarioDef& def);
+ScenarioCfg build_scenario(const ScenarioDef& def,PhysicsEngine& e);
+
+// Sets a numeric scenario key as if it appeared in the file. Global keys
+// use their plain name (timestep_seconds); entity keys are <entity>.<key>.
+bool apply_scenario_override(ScenarioDef& def,const std::string& key,double value);
+
 ScenarioCfg load_scenario(const std::string& path,PhysicsEngine& e);
+
+// Attaches the run ephemeris and enables the force terms the scenario asks for.
+bool configure_engine(PhysicsEngine& e,const ScenarioCfg& cfg,std::shared_ptr<const Ephemeris> eph);
@@ -1,5 +1,30 @@
 #pragma once
+#include <string>
 #include "physics/engine.hpp"
 #include "sim/scenario.hpp"
 #include "core/output.hpp"
-void run_sim(PhysicsEngine& e,const ScenarioCfg& cfg,double speed,const char* simfile,OutputWriter* ow);
+
+struct SimOptions{
+    double speed = 0.0;             // sim seconds per wall second; 0 = from speed_file
+    std::string speed_file = "models/sim_speed.txt";   // re-read when it changes
+    double tick_hz = 50.0;          // scheduler rate (wall)
+    int max_catchup_steps = 8;      // extra steps a tick may take to repay a stall
+    double report_every_s = 1.0;    // wall seconds between stats lines
+};
+
+struct SimStats{
+    size_t ticks = 0, steps = 0;
+    size_t overruns = 0;            // ticks whose work ran past the next deadline
+    size_t missed_ticks = 0;        // deadlines skipped after an overrun
+    double slip_s = 0.0;            // sim time dropped by the catch-up cap
+    double step_p50_ms = 0.0, step_p99_ms = 0.0, step_max_ms = 0.0;  // work per tick
+    double jitter_p50_ms = 0.0, jitter_p99_ms = 0.0;                  // wake-up lateness
+};
+
+// Real-time run: a fixed-rate wall-clock tick owes speed * elapsed of sim
+// time and pays it in whole engine steps. A tick takes at most its own
+// quota plus max_catchup_steps; anything beyond is dropped and reported as
+// slip rather than replayed, so a stall cannot snowball. Ticks sleep to
+// absolute deadlines; a tick that overruns skips the deadlines it missed.
+// Prints a stats line every report_every_s and returns the whole-run stats.
+SimStats run_sim(PhysicsEngine& e, const ScenarioCfg& cfg, const SimOptions& opt, OutputWriter* ow);
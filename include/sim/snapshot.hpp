@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+#include "physics/engine.hpp"
+#include "sim/scenario.hpp"
+
+// Binary scenario snapshot (.scn): ScenarioCfg, entity names and fully
+// initialized ECI bodies, laid out so the body table can be mapped and
+// copied into engine storage in one pass.
+bool compile_scenario(const std::string& in_path,
+                      const std::string& out_path);
+
+// True if the file starts with the snapshot magic or is named *.scn; a
+// damaged .scn then fails to load instead of being read as a text scenario.
+bool is_scenario_snapshot(const std::string& path);
+
+// Appends the snapshot's bodies to `e`; false, with a message, if the file
+// is unreadable, from another build layout or corrupt.
+bool load_scenario_snapshot(const std::string& path, PhysicsEngine& e, ScenarioCfg& cfg);
@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "physics/publish.hpp"
+
+// Live state over a local socket (see sim/local_socket.hpp for endpoints).
+//
+// Client -> server, one ASCII line per request (re-send to change it):
+//   SUB <max_hz> <name,name,...|*>\n      max_hz 0 = every new snapshot
+// Server -> client, little-endian frames: TelemetryFrameHeader, then
+//   SCHEMA: count x {u32 body index, u16 name length, name bytes}, sent on
+//           subscribing and whenever the body list changes;
+//   STATE:  count x {f64 x, y, z (km), vx, vy, vz (km/s)} in schema order;
+//   DROP:   no records; the server is dropping this client for falling
+//           behind, and closes the stream after it.
+
+static constexpr uint32_t TELEMETRY_MAGIC = 0x4d545353;    // "SSTM"
+static constexpr uint16_t TELEMETRY_VERSION = 1;
+static constexpr uint32_t TELEMETRY_STATE_RECORD = 48;
+
+enum TelemetryFrameType : uint16_t {
+    TELEMETRY_SCHEMA = 1,
+    TELEMETRY_STATE = 2,
+    TELEMETRY_DROP = 3,
+};
+
+struct TelemetryFrameHeader{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;
+    uint64_t seq;                   // snapshot publish count
+    double time;                    // engine time, s
+    uint32_t count;                 // records
+    uint32_t payload_bytes;
+};
+static_assert(sizeof(TelemetryFrameHeader) == 32, "telemetry header is 32 bytes on the wire");
+
+struct TelemetryOptions{
+    std::string endpoint;
+    size_t max_queue_bytes = 8u<<20;    // per client; a client over this is dropped
+    double drop_linger_s = 2.0;         // wait for a dropped client to take the DROP frame
+    size_t max_clients = 16;
+    int poll_ms = 5;
+};
+
+// Serves one StatePublisher reader on its own thread. The stepping thread
+// only publishes; encoding and socket I/O happen here, all non-blocking,
+// and each client has a bounded send queue, so a slow client is dropped
+// rather than slowing the simulation. A dropped client's backlog is
+// discarded for a DROP frame, and it is closed once that is sent or after
+// drop_linger_s.
+class TelemetryServer{
+public:
+    TelemetryServer(StatePublisher& pub, const TelemetryOptions& opt);
+    ~TelemetryServer();
+
+    // Binds, registers the publisher reader and starts serving. Call
+    // before stepping starts; false (with a message) if the endpoint
+    // cannot be bound.
+    bool start();
+    void stop();
+
+    size_t clients_served() const { return served.load(); }
+    size_t clients_dropped() const { return dropped.load(); }
+
+private:
+    struct Client{
+        int fd = -1;
+        std::string inbox;
+        double max_hz = 0.0;
+        std::vector<std::string> want;      // empty = all
+        bool subscribed = false, need_schema = false;
+        std::vector<uint32_t> sel;
+        size_t sel_for_bodies = 0;
+        uint64_t last_seq = 0;
+        double next_send_s = 0.0;
+        std::deque<std::vector<char>> queue;
+        size_t queued = 0, head_sent = 0;
+        bool dropping = false;
+        double drop_deadline_s = 0.0;
+    };
+
+    void run();
+    void accept_clients();
+    bool read_requests(Client& c);
+    bool flush(Client& c);
+    void enqueue(Client& c, const StateSnapshot& s, double now_s);
+    void close_client(Client& c);
+    void drop_client(Client& c, const StateSnapshot& s, double now_s);
+
+    StatePublisher& pub;
+    TelemetryOptions opt;
+    size_t reader = 0;
+    int listen_fd = -1;
+    std::string unix_path;
+    std::vector<std::unique_ptr<Client>> clients;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<size_t> served{0}, dropped{0};
+};
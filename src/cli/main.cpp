@@ -1,18 +1,85 @@
 #include "physics/engine.hpp"
 #include "sim/scenario.hpp"
 #include "sim/expand_scenario.hpp"
+#include "sim/snapshot.hpp"
+#include "sim/checkpoint.hpp"
+#include "sim/sim.hpp"
+#include "sim/telemetry.hpp"
 #include "model/model.hpp"
 #include "model/rocket_model.hpp"
 #include "model/tle_report.hpp"
 #include "core/output.hpp"
+#include "core/solarsystem.hpp"
+#include "physics/ephemeris.hpp"
 #include "model/lambert_demo.hpp"
+#include "model/sweep.hpp"
+#include "model/bench.hpp"
+#include "model/lifetime.hpp"
+#include "model/secular_model.hpp"
+#include "model/access.hpp"
+#include "model/eclipse.hpp"
+#include "model/porkchop.hpp"
+#include "model/reach.hpp"
+#include "model/conjunction.hpp"
+#include "model/serve.hpp"
+#include "core/cities.hpp"
 #include <iostream>
 #include <string>
 
 static void usage(){
     std::cerr << "usage:\n";
-    std::cerr << "  spacesim2 --model <scenario> [--output <file> --outputrate <sec>]\n";
+    std::cerr << "  spacesim2 --model <scenario|snapshot.scn> [--output <file> --outputrate <sec>]\n";
+    std::cerr << "                    [--checkpoint-every <sec> <dir>] [--resume <checkpoint>]\n";
+    std::cerr << "                    [--ephemeris <file.eph>]\n";
+    std::cerr << "  spacesim2 --sim <scenario|snapshot.scn> [--speed <x>] [--hz <ticks/s>] [--max-catchup <steps>]\n";
+    std::cerr << "                  [--output <file> --outputrate <sec>] [--ephemeris <file.eph>]\n";
+    std::cerr << "                  [--telemetry unix:<path>|tcp:<port>] [--telemetry-queue <bytes>]\n";
     std::cerr << "  spacesim2 --expand <in.scenario> <out.scenario>\n";
+    std::cerr << "  spacesim2 --compile <in.scenario> <out.scn>\n";
+    std::cerr << "  spacesim2 --sweep <sweep-spec>\n";
+    std::cerr << "  spacesim2 --fit-ephemeris <scenario> <out.eph>\n";
+    std::cerr << "  spacesim2 --bench-forces [bodies] [steps]\n";
+    std::cerr << "  spacesim2 --bench-lambert [cases]\n";
+    std::cerr << "  spacesim2 --lifetime <tles.txt> [--output <file.csv>] [--horizon-years <y>]\n";
+    std::cerr << "                       [--default-bc <m2/kg>] [--threads <n>]\n";
+    std::cerr << "  spacesim2 --access <tles.txt> [--output <file.csv>] [--hours <h>] [--min-el <deg>]\n";
+    std::cerr << "                     [--step <sec>] [--start-jd <jd>] [--threads <n>]\n";
+    std::cerr << "  spacesim2 --eclipses <scenario|snapshot.scn> [--output <file.csv>] [--ephemeris <file.eph>]\n";
+    std::cerr << "  spacesim2 --porkchop <scenario|snapshot.scn> [--chaser <name>] [--target <name>]\n";
+    std::cerr << "                       [--depart <start_h> <end_h> <step_h>] [--tof <min_h> <max_h> <step_h>]\n";
+    std::cerr << "                       [--max-rev <n>] [--lambert uv|izzo] [--output <file.csv>] [--threads <n>]\n";
+    std::cerr << "  spacesim2 --reach <tles.txt> --chasers <name,...> [--tof <min_h> <max_h> <step_h>]\n";
+    std::cerr << "                    [--max-dv <m/s>] [--max-rev <n>] [--start-jd <jd>] [--cold]\n";
+    std::cerr << "                    [--output <file.csv>] [--threads <n>]\n";
+    std::cerr << "  spacesim2 --pc <events.csv> [--method auto|series|integrate] [--output <file.csv>]\n";
+    std::cerr << "                 [--threads <n>]\n";
+    std::cerr << "  spacesim2 --serve <scenario|snapshot.scn> --listen unix:<path>|tcp:<port> [--grid <sec>]\n";
+    std::cerr << "                    [--cache <states>] [--ephemeris <file.eph>] [--horizon-days <d>]\n";
+    std::cerr << "  spacesim2 --query unix:<path>|tcp:<port> <STATE|NEAREST|WITHIN|INFO ...>\n";
+}
+
+// Scenario (or snapshot) plus the environment ephemeris fitted over the run
+// window (or loaded from eph_file), engine configured for the scenario.
+static bool load_configured(const std::string& scenario_path, const std::string& eph_file,
+                            PhysicsEngine& e, ScenarioCfg& cfg){
+    if(is_scenario_snapshot(scenario_path)){
+        if(!load_scenario_snapshot(scenario_path, e, cfg)) return false;
+    }else{
+        cfg = load_scenario(scenario_path, e);
+    }
+
+    load_solar_system();
+    auto eph = std::make_shared<Ephemeris>();
+    if(!eph_file.empty()){
+        if(!eph->load(eph_file)){
+            std::cerr << "ephemeris: failed to load " << eph_file << "\n";
+            return false;
+        }
+    }else{
+        eph->fit_analytic(cfg.epoch_jd, cfg.t_end + 86400.0);
+    }
+    refresh_environment(*eph, 0.0);
+    return configure_engine(e, cfg, std::move(eph));
 }
 
 int main(int argc, char** argv){
@@ -38,6 +105,280 @@ int main(int argc, char** argv){
         return 0;
     }
 
+    if(mode == "--compile"){
+        if(argc < 4){
+            usage();
+            return 2;
+        }
+        std::string in_path = argv[2];
+        std::string out_path = argv[3];
+        if(!compile_scenario(in_path, out_path)){
+            std::cerr << "compile failed: " << in_path << " -> " << out_path << "\n";
+            return 1;
+        }
+        std::cout << "compiled scenario written: " << out_path << "\n";
+        return 0;
+    }
+
+    if(mode == "--sweep"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        return run_sweep(argv[2]) ? 0 : 1;
+    }
+
+    if(mode == "--fit-ephemeris"){
+        if(argc < 4){
+            usage();
+            return 2;
+        }
+        PhysicsEngine e;
+        ScenarioCfg cfg = load_scenario(argv[2], e);
+        Ephemeris eph;
+        eph.fit_analytic(cfg.epoch_jd, cfg.t_end + 86400.0);
+        if(!eph.save(argv[3])){
+            std::cerr << "fit-ephemeris: cannot write " << argv[3] << "\n";
+            return 1;
+        }
+        std::cout << "ephemeris written: " << argv[3] << "\n";
+        return 0;
+    }
+
+    if(mode == "--bench-forces"){
+        const size_t bodies = argc > 2 ? (size_t)std::stoul(argv[2]) : 10000;
+        const int steps = argc > 3 ? std::stoi(argv[3]) : 200;
+        load_solar_system();
+        return run_force_bench(bodies, steps) ? 0 : 1;
+    }
+
+    if(mode == "--bench-lambert"){
+        const size_t cases = argc > 2 ? (size_t)std::stoul(argv[2]) : 100000;
+        return run_lambert_bench(cases) ? 0 : 1;
+    }
+
+    if(mode == "--lifetime"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        LifetimeOptions opt;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--output" && i+1<argc) opt.output = argv[++i];
+            else if(a=="--horizon-years" && i+1<argc) opt.horizon_years = std::stod(argv[++i]);
+            else if(a=="--default-bc" && i+1<argc) opt.default_bc_m2_kg = std::stod(argv[++i]);
+            else if(a=="--threads" && i+1<argc) opt.threads = (size_t)std::stoul(argv[++i]);
+        }
+        return run_lifetime(argv[2], opt) ? 0 : 1;
+    }
+
+    if(mode == "--access"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        AccessOptions opt;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--output" && i+1<argc) opt.output = argv[++i];
+            else if(a=="--hours" && i+1<argc) opt.hours = std::stod(argv[++i]);
+            else if(a=="--min-el" && i+1<argc) opt.min_elevation_deg = std::stod(argv[++i]);
+            else if(a=="--step" && i+1<argc) opt.step_s = std::stod(argv[++i]);
+            else if(a=="--start-jd" && i+1<argc) opt.start_jd = std::stod(argv[++i]);
+            else if(a=="--threads" && i+1<argc) opt.threads = (size_t)std::stoul(argv[++i]);
+        }
+        load_global_cities();
+        return run_access(argv[2], opt) ? 0 : 1;
+    }
+
+    if(mode == "--eclipses"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        std::string out_file, eph_file;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--output" && i+1<argc) out_file = argv[++i];
+            else if(a=="--ephemeris" && i+1<argc) eph_file = argv[++i];
+        }
+        PhysicsEngine e;
+        ScenarioCfg cfg;
+        if(!load_configured(argv[2], eph_file, e, cfg)) return 1;
+        return run_eclipses(e, cfg, out_file) ? 0 : 1;
+    }
+
+    if(mode == "--porkchop"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        PorkchopOptions opt;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--chaser" && i+1<argc) opt.chaser = argv[++i];
+            else if(a=="--target" && i+1<argc) opt.target = argv[++i];
+            else if(a=="--depart" && i+3<argc){
+                opt.depart_start_h = std::stod(argv[++i]);
+                opt.depart_end_h = std::stod(argv[++i]);
+                opt.depart_step_h = std::stod(argv[++i]);
+            }
+            else if(a=="--tof" && i+3<argc){
+                opt.tof_min_h = std::stod(argv[++i]);
+                opt.tof_max_h = std::stod(argv[++i]);
+                opt.tof_step_h = std::stod(argv[++i]);
+            }
+            else if(a=="--max-rev" && i+1<argc) opt.max_rev = std::stoi(argv[++i]);
+            else if(a=="--lambert" && i+1<argc){
+                if(!lambert_method_from_name(argv[++i], opt.lambert)){
+                    std::cerr << "porkchop: unknown Lambert method '" << argv[i] << "'\n";
+                    return 2;
+                }
+            }
+            else if(a=="--output" && i+1<argc) opt.output = argv[++i];
+            else if(a=="--threads" && i+1<argc) opt.threads = (size_t)std::stoul(argv[++i]);
+        }
+        PhysicsEngine e;
+        ScenarioCfg cfg;
+        if(is_scenario_snapshot(argv[2])){
+            if(!load_scenario_snapshot(argv[2], e, cfg)) return 1;
+        }else{
+            cfg = load_scenario(argv[2], e);
+        }
+        return run_porkchop(e, cfg, opt) ? 0 : 1;
+    }
+
+    if(mode == "--reach"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        ReachOptions opt;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--chasers" && i+1<argc) opt.chasers = argv[++i];
+            else if(a=="--tof" && i+3<argc){
+                opt.tof_min_h = std::stod(argv[++i]);
+                opt.tof_max_h = std::stod(argv[++i]);
+                opt.tof_step_h = std::stod(argv[++i]);
+            }
+            else if(a=="--max-dv" && i+1<argc) opt.max_dv_m_s = std::stod(argv[++i]);
+            else if(a=="--max-rev" && i+1<argc) opt.max_rev = std::stoi(argv[++i]);
+            else if(a=="--start-jd" && i+1<argc) opt.start_jd = std::stod(argv[++i]);
+            else if(a=="--cold") opt.warm_start = false;
+            else if(a=="--output" && i+1<argc) opt.output = argv[++i];
+            else if(a=="--threads" && i+1<argc) opt.threads = (size_t)std::stoul(argv[++i]);
+        }
+        return run_reach(argv[2], opt) ? 0 : 1;
+    }
+
+    if(mode == "--serve"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        ServeOptions opt;
+        std::string eph_file;
+        double horizon_days = 365.0;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--listen" && i+1<argc) opt.endpoint = argv[++i];
+            else if(a=="--grid" && i+1<argc) opt.grid_s = std::stod(argv[++i]);
+            else if(a=="--cache" && i+1<argc) opt.cache_states = (size_t)std::stoul(argv[++i]);
+            else if(a=="--ephemeris" && i+1<argc) eph_file = argv[++i];
+            else if(a=="--horizon-days" && i+1<argc) horizon_days = std::stod(argv[++i]);
+        }
+        if(opt.endpoint.empty()){
+            usage();
+            return 2;
+        }
+        PhysicsEngine e;
+        ScenarioCfg cfg;
+        if(!load_configured(argv[2], eph_file, e, cfg)) return 1;
+        // queries range well past the scenario's own run window
+        if(eph_file.empty()){
+            auto eph = std::make_shared<Ephemeris>();
+            eph->fit_analytic(cfg.epoch_jd, horizon_days*86400.0);
+            e.ephemeris = std::move(eph);
+        }
+        return run_serve(e, cfg, opt) ? 0 : 1;
+    }
+
+    if(mode == "--query"){
+        if(argc < 4){
+            usage();
+            return 2;
+        }
+        std::string request = argv[3];
+        for(int i=4;i<argc;i++) request += std::string(" ") + argv[i];
+        return run_query(argv[2], request) ? 0 : 1;
+    }
+
+    if(mode == "--pc"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        PcOptions opt;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--method" && i+1<argc){
+                if(!pc_method_from_name(argv[++i], opt.method)){
+                    std::cerr << "pc: unknown method '" << argv[i] << "'\n";
+                    return 2;
+                }
+            }
+            else if(a=="--output" && i+1<argc) opt.output = argv[++i];
+            else if(a=="--threads" && i+1<argc) opt.threads = (size_t)std::stoul(argv[++i]);
+        }
+        return run_pc(argv[2], opt) ? 0 : 1;
+    }
+
+    if(mode == "--sim"){
+        if(argc < 3){
+            usage();
+            return 2;
+        }
+        SimOptions opt;
+        TelemetryOptions topt;
+        std::string out_file, eph_file;
+        double out_rate = 0.0;
+        for(int i=3;i<argc;i++){
+            std::string a = argv[i];
+            if(a=="--speed" && i+1<argc) opt.speed = std::stod(argv[++i]);
+            else if(a=="--hz" && i+1<argc) opt.tick_hz = std::stod(argv[++i]);
+            else if(a=="--max-catchup" && i+1<argc) opt.max_catchup_steps = std::stoi(argv[++i]);
+            else if(a=="--output" && i+1<argc) out_file = argv[++i];
+            else if(a=="--outputrate" && i+1<argc) out_rate = std::stod(argv[++i]);
+            else if(a=="--ephemeris" && i+1<argc) eph_file = argv[++i];
+            else if(a=="--telemetry" && i+1<argc) topt.endpoint = argv[++i];
+            else if(a=="--telemetry-queue" && i+1<argc) topt.max_queue_bytes = (size_t)std::stoul(argv[++i]);
+        }
+        PhysicsEngine e;
+        ScenarioCfg cfg;
+        if(!load_configured(argv[2], eph_file, e, cfg)) return 1;
+        if(cfg.propagator != PROPAGATOR_NUMERIC){
+            std::cerr << "sim: real-time runs need the numeric propagator\n";
+            return 1;
+        }
+        StatePublisher pub;
+        TelemetryServer telemetry(pub, topt);
+        if(!topt.endpoint.empty()){
+            if(!telemetry.start()) return 1;
+            e.publisher = &pub;
+        }
+        OutputWriter ow;
+        if(!out_file.empty() && out_rate > 0.0) ow.open(out_file, out_rate);
+        run_sim(e, cfg, opt, ow.enabled() ? &ow : nullptr);
+        if(!topt.endpoint.empty()){
+            telemetry.stop();
+            std::cout << "telemetry clients " << telemetry.clients_served()
+                      << " dropped " << telemetry.clients_dropped() << "\n";
+        }
+        return 0;
+    }
+
     if(mode != "--model"){
         usage();
         return 2;
@@ -52,37 +393,85 @@ int main(int argc, char** argv){
 
     std::string out_file;
     double out_rate = 0.0;
+    std::string ckpt_dir;
+    double ckpt_every = 0.0;
+    std::string resume_path;
+    std::string eph_file;
 
     for(int i=3;i<argc;i++){
         std::string a = argv[i];
         if(a=="--output" && i+1<argc) out_file = argv[++i];
         else if(a=="--outputrate" && i+1<argc) out_rate = std::stod(argv[++i]);
+        else if(a=="--checkpoint-every" && i+2<argc){ ckpt_every = std::stod(argv[++i]); ckpt_dir = argv[++i]; }
+        else if(a=="--resume" && i+1<argc) resume_path = argv[++i];
+        else if(a=="--ephemeris" && i+1<argc) eph_file = argv[++i];
     }
 
+    // Environment bodies follow a Chebyshev ephemeris fitted over the run window.
     PhysicsEngine e;
-    ScenarioCfg cfg = load_scenario(scenario_path, e);
+    ScenarioCfg cfg;
+    if(!load_configured(scenario_path, eph_file, e, cfg)) return 1;
 
 
     // Lambert demo
-    if(scenario_path.find("lambert_demo") != std::string::npos){
+    if(cfg.model == MODEL_LAMBERT_DEMO){
         run_lambert_demo(e);
         return 0;
     }
+    Checkpoint resume;
+    Checkpoint* resume_ptr = nullptr;
+    if(!resume_path.empty()){
+        if(!load_checkpoint(resume_path, resume)){
+            std::cerr << "resume failed: " << resume_path << "\n";
+            return 1;
+        }
+        if(resume.dt != cfg.dt || resume.t_end != cfg.t_end){
+            std::cerr << "resume: checkpoint does not match scenario timestep/duration\n";
+            return 1;
+        }
+        e.bodies = resume.bodies;
+        e.names  = resume.names;
+        e.time   = resume.engine_time;
+        resume_ptr = &resume;
+    }
+
     OutputWriter ow;
     OutputWriter* ow_ptr = nullptr;
     if(!out_file.empty() && out_rate > 0.0){
-        ow.open(out_file, out_rate);
+        if(resume_ptr && resume.has_output){
+            if(!ow.resume(out_file, out_rate, resume.output_next_t, resume.output_offset)){
+                std::cerr << "resume: cannot reopen output " << out_file << "\n";
+                return 1;
+            }
+        }else{
+            ow.open(out_file, out_rate);
+        }
         ow_ptr = &ow;
     }
 
-    if(scenario_path.find("tle_hour") != std::string::npos){
-        run_tle_hour_report(e, cfg, ow_ptr);
+    Checkpointer cp;
+    Checkpointer* cp_ptr = nullptr;
+    if(!ckpt_dir.empty() && ckpt_every > 0.0){
+        cp.open(ckpt_dir, ckpt_every, resume_ptr ? resume.t : 0.0);
+        cp_ptr = &cp;
+    }
+
+    if(cfg.propagator == PROPAGATOR_SECULAR_J2){
+        if(resume_ptr || cp_ptr){
+            std::cerr << "secular_j2: checkpoint/resume not supported (states are closed-form)\n";
+            return 1;
+        }
+        run_secular_model(e, cfg.t_end, ow_ptr);
+        return 0;
+    }
+    if(cfg.model == MODEL_TLE_HOUR){
+        run_tle_hour_report(e, cfg, ow_ptr, cp_ptr, resume_ptr);
         return 0;
     }
-    if(scenario_path.find("rocket") != std::string::npos){
-        run_rocket_model(e, cfg.dt, cfg.t_end, ow_ptr);
+    if(cfg.model == MODEL_ROCKET){
+        run_rocket_model(e, cfg.dt, cfg.t_end, ow_ptr, cp_ptr, resume_ptr);
         return 0;
     }
-    run_model(e, cfg.dt, cfg.t_end, ow_ptr);
+    run_model(e, cfg.dt, cfg.t_end, ow_ptr, cp_ptr, resume_ptr);
     return 0;
 }
@@ -0,0 +1,156 @@
+// Subscribes to a running `spacesim2 --sim ... --telemetry <endpoint>` and
+// checks the stream: framing, schema/state agreement, ordering and values.
+// Exits 1 on the first bad frame, so it doubles as the server's test.
+// With --stall it stops reading and passes only if the server then drops
+// it with a DROP frame; a stream that just ends (the sim finished) fails.
+#include "sim/telemetry.hpp"
+#include "sim/local_socket.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void usage(){
+    std::cerr << "usage:\n";
+    std::cerr << "  spacesim2-telemetry unix:<path>|tcp:<port> [--hz <max>] [--entities <name,...>]\n";
+    std::cerr << "                      [--frames <n>] [--stall <sec>] [--quiet]\n";
+}
+
+static bool read_full(int fd, void* dst, size_t n){
+    char* p = (char*)dst;
+    while(n){
+        const ssize_t got = ::recv(fd, p, n, 0);
+        if(got <= 0) return false;
+        p += got;
+        n -= (size_t)got;
+    }
+    return true;
+}
+
+static bool send_full(int fd, const std::string& s){
+    size_t off = 0;
+    while(off < s.size()){
+        const ssize_t n = ::send(fd, s.data() + off, s.size() - off, MSG_NOSIGNAL);
+        if(n <= 0) return false;
+        off += (size_t)n;
+    }
+    return true;
+}
+
+static int fail(const std::string& msg){
+    std::cerr << "telemetry-client: " << msg << "\n";
+    return 1;
+}
+
+int main(int argc, char** argv){
+    if(argc < 2){
+        usage();
+        return 2;
+    }
+    const std::string endpoint = argv[1];
+    std::string entities = "*";
+    double hz = 0.0, stall_s = 0.0;
+    size_t frames = 0;
+    bool quiet = false;
+    for(int i=2;i<argc;i++){
+        std::string a = argv[i];
+        if(a=="--hz" && i+1<argc) hz = std::stod(argv[++i]);
+        else if(a=="--entities" && i+1<argc) entities = argv[++i];
+        else if(a=="--frames" && i+1<argc) frames = (size_t)std::stoul(argv[++i]);
+        else if(a=="--stall" && i+1<argc) stall_s = std::stod(argv[++i]);
+        else if(a=="--quiet") quiet = true;
+        else{
+            usage();
+            return 2;
+        }
+    }
+
+    const int fd = local_connect(endpoint);
+    if(fd < 0) return fail("cannot connect to " + endpoint);
+    if(!send_full(fd, "SUB " + std::to_string(hz) + " " + entities + "\n")) return fail("cannot send subscription");
+
+    // A stalled client stops reading so the server's queue for it fills;
+    // what it then reads is still checked frame by frame.
+    if(stall_s > 0.0){
+        std::this_thread::sleep_for(std::chrono::duration<double>(stall_s));
+        quiet = true;
+        frames = 0;
+    }
+
+    std::vector<std::string> names;
+    std::vector<char> payload;
+    std::vector<double> rec;
+    bool have_schema = false;
+    uint64_t last_seq = 0, states = 0, schemas = 0, bytes = 0;
+    double last_time = -INFINITY;
+    const auto t0 = std::chrono::steady_clock::now();
+    while(frames == 0 || states < frames){
+        TelemetryFrameHeader h;
+        if(!read_full(fd, &h, sizeof(h))){
+            if(stall_s > 0.0) return fail("stream ended without a DROP frame (no drop; did the sim finish?)");
+            if(states == 0) return fail("stream closed before any state frame");
+            break;
+        }
+        if(h.magic != TELEMETRY_MAGIC) return fail("bad magic");
+        if(h.version != TELEMETRY_VERSION) return fail("unsupported version " + std::to_string(h.version));
+        payload.resize(h.payload_bytes);
+        if(h.payload_bytes && !read_full(fd, payload.data(), h.payload_bytes)) return fail("truncated payload");
+        bytes += sizeof(h) + h.payload_bytes;
+
+        if(h.type == TELEMETRY_SCHEMA){
+            names.clear();
+            size_t off = 0;
+            for(uint32_t k=0;k<h.count;k++){
+                uint16_t len = 0;
+                if(off + 6 > payload.size()) return fail("schema record overruns payload");
+                std::memcpy(&len, payload.data() + off + 4, 2);
+                if(off + 6 + len > payload.size()) return fail("schema name overruns payload");
+                names.emplace_back(payload.data() + off + 6, len);
+                off += 6 + len;
+            }
+            if(off != payload.size()) return fail("schema payload has trailing bytes");
+            have_schema = true;
+            schemas++;
+            if(!quiet) std::cout << "schema seq " << h.seq << " entities " << h.count << "\n";
+            continue;
+        }
+        if(h.type == TELEMETRY_DROP){
+            if(stall_s <= 0.0) return fail("dropped by the server");
+            if(h.count || h.payload_bytes) return fail("DROP frame has a payload");
+            ::close(fd);
+            std::cout << "TELEMETRY_DROPPED after stalling " << stall_s << " s; read " << states
+                      << " states, " << bytes << " bytes\n";
+            return 0;
+        }
+        if(h.type != TELEMETRY_STATE) return fail("unknown frame type " + std::to_string(h.type));
+        if(!have_schema) return fail("state frame before schema");
+        if(h.count != names.size()) return fail("state count disagrees with schema");
+        if(h.payload_bytes != (uint64_t)h.count*TELEMETRY_STATE_RECORD) return fail("state payload size mismatch");
+        if(h.seq <= last_seq) return fail("seq did not increase");
+        if(h.time < last_time) return fail("time went backwards");
+        rec.resize(h.count*6);
+        std::memcpy(rec.data(), payload.data(), payload.size());
+        for(double v : rec) if(!std::isfinite(v)) return fail("non-finite state value");
+        if(!quiet){
+            std::cout << "state seq " << h.seq << " t " << h.time << " entities " << h.count;
+            if(h.count){
+                const double r = std::sqrt(rec[0]*rec[0] + rec[1]*rec[1] + rec[2]*rec[2]);
+                std::cout << " " << names[0] << " r_km " << r;
+            }
+            std::cout << "\n";
+        }
+        last_seq = h.seq;
+        last_time = h.time;
+        states++;
+    }
+    ::close(fd);
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "TELEMETRY_OK states " << states << " schemas " << schemas << " bytes " << bytes
+              << " wall_s " << wall << " rate_hz " << (wall > 0.0 ? states/wall : 0.0) << "\n";
+    return 0;
+}
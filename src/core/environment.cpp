@@ -16,3 +16,11 @@ const EnvEntity& Environment::get(const std::string& n) const{
 const std::unordered_map<std::string,EnvEntity>& Environment::all() const{
     return entities;
 }
+
+bool Environment::has(const std::string& n) const{
+    return entities.count(n)!=0;
+}
+
+void Environment::set_body(const std::string& n,const Body& b){
+    entities.at(n).body=b;
+}
@@ -0,0 +1,95 @@
+#include "core/frames.hpp"
+#include "core/geodesy.hpp"
+#include <cmath>
+#include <vector>
+
+static constexpr double DEG = M_PI/180.0;
+static constexpr double WGS84_B_KM = WGS84_A_KM*(1.0 - WGS84_F);
+static constexpr double WGS84_EP2 = WGS84_E2/(1.0 - WGS84_E2); // second eccentricity^2
+
+void eci_to_ecef(double gmst, const double r[3], const double v[3], double re[3], double ve[3]){
+    const double c = std::cos(gmst), s = std::sin(gmst);
+    re[0] =  c*r[0] + s*r[1];
+    re[1] = -s*r[0] + c*r[1];
+    re[2] =  r[2];
+    if(v && ve){
+        ve[0] =  c*v[0] + s*v[1] + OMEGA_EARTH_RAD_S*re[1];
+        ve[1] = -s*v[0] + c*v[1] - OMEGA_EARTH_RAD_S*re[0];
+        ve[2] =  v[2];
+    }
+}
+
+void ecef_to_eci(double gmst, const double re[3], const double ve[3], double r[3], double v[3]){
+    const double c = std::cos(gmst), s = std::sin(gmst);
+    r[0] = c*re[0] - s*re[1];
+    r[1] = s*re[0] + c*re[1];
+    r[2] = re[2];
+    if(ve && v){
+        const double wx = ve[0] - OMEGA_EARTH_RAD_S*re[1];
+        const double wy = ve[1] + OMEGA_EARTH_RAD_S*re[0];
+        v[0] = c*wx - s*wy;
+        v[1] = s*wx + c*wy;
+        v[2] = ve[2];
+    }
+}
+
+std::array<double,3> geodetic_to_ecef(double lat_deg, double lon_deg, double alt_km){
+    const double lat = lat_deg*DEG, lon = lon_deg*DEG;
+    const double sl = std::sin(lat), cl = std::cos(lat);
+    const double N = WGS84_A_KM/std::sqrt(1.0 - WGS84_E2*sl*sl);
+    return {
+        (N + alt_km)*cl*std::cos(lon),
+        (N + alt_km)*cl*std::sin(lon),
+        (N*(1.0 - WGS84_E2) + alt_km)*sl
+    };
+}
+
+// Bowring: parametric latitude from (z a, p b), then one closed-form update.
+// Returns the (unnormalized) sine/cosine components of geodetic latitude
+// and the height, using only sqrt and division.
+static inline void bowring(double p, double z, double& sn, double& cs, double& h){
+    const double u = z*WGS84_A_KM, w = p*WGS84_B_KM;
+    const double inv = 1.0/std::sqrt(u*u + w*w + 1e-300);
+    const double st = u*inv, ct = w*inv;
+    sn = z + WGS84_EP2*WGS84_B_KM*st*st*st;
+    cs = p - WGS84_E2*WGS84_A_KM*ct*ct*ct;
+    const double k = 1.0/std::sqrt(sn*sn + cs*cs);
+    const double sl = sn*k, cl = cs*k;
+    // h = p cos(lat) + z sin(lat) - a sqrt(1 - e^2 sin^2 lat)
+    h = p*cl + z*sl - WGS84_A_KM*std::sqrt(1.0 - WGS84_E2*sl*sl);
+}
+
+void ecef_to_geodetic(double x, double y, double z, double& lat_deg, double& lon_deg, double& alt_km){
+    const double p = std::sqrt(x*x + y*y);
+    double sn, cs;
+    bowring(p, z, sn, cs, alt_km);
+    lat_deg = std::atan2(sn, cs)/DEG;
+    lon_deg = std::atan2(y, x)/DEG;
+}
+
+void eci_to_lla_batch(double jd, size_t n, const double* xyz, size_t stride,
+                      double* lat_deg, double* lon_deg, double* alt_km){
+    const double g = gmst_rad(jd);
+    const double c = std::cos(g), s = std::sin(g);
+
+    // Pass 1: rotate and reduce (arithmetic only). lat/lon arrays hold the
+    // atan2 arguments until pass 2.
+    for(size_t i=0;i<n;i++){
+        const double* r = xyz + i*stride;
+        const double x =  c*r[0] + s*r[1];
+        const double y = -s*r[0] + c*r[1];
+        const double z =  r[2];
+        const double p = std::sqrt(x*x + y*y);
+        double sn, cs;
+        bowring(p, z, sn, cs, alt_km[i]);
+        lat_deg[i] = sn/cs;   // tan(lat); cs >= 0 off the polar axis
+        lon_deg[i] = x;
+    }
+    // Pass 2: angles.
+    for(size_t i=0;i<n;i++){
+        const double* r = xyz + i*stride;
+        const double y = -s*r[0] + c*r[1];
+        lat_deg[i] = std::atan(lat_deg[i])/DEG;
+        lon_deg[i] = std::atan2(y, lon_deg[i])/DEG;
+    }
+}
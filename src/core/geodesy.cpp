@@ -1,17 +1,13 @@
 #include "core/geodesy.hpp"
+#include "core/frames.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 
-static constexpr double R_E=6378.137;
 static constexpr double DEG=M_PI/180.0;
 
 std::array<double,3> lla_to_ecef(double lat,double lon,double alt){
-    lat*=DEG; lon*=DEG;
-    double r=R_E+alt;
-    return {
-        r*cos(lat)*cos(lon),
-        r*cos(lat)*sin(lon),
-        r*sin(lat)
-    };
+    return geodetic_to_ecef(lat,lon,alt);
 }
 
 double local_solar_time_hours(double lon_deg,double jd){
@@ -26,3 +22,38 @@ double ecef_lon_deg(double x,double y,double){
     double lon=atan2(y,x)*180.0/M_PI;
     return lon;
 }
+
+double gmst_rad(double jd){
+    const double d=jd-2451545.0;
+    const double T=d/36525.0;
+    double g=fmod(280.46061837 + 360.98564736629*d + 0.000387933*T*T - T*T*T/38710000.0, 360.0);
+    if(g<0) g+=360.0;
+    return g*DEG;
+}
+
+// Meeus, ch. 7.
+std::string jd_to_utc(double jd, bool seconds){
+    // Rounded to the printed resolution first, so 23:59:59.6 carries into
+    // the next day rather than the time field.
+    const double units = seconds ? 86400.0 : 1440.0;
+    const double n = std::floor((jd + 0.5)*units + 0.5);
+    const double z = std::floor(n/units);
+    const int t = (int)(n - z*units);
+    const double alpha = std::floor((z - 1867216.25)/36524.25);
+    const double A = z + 1.0 + alpha - std::floor(alpha/4.0);
+    const double B = A + 1524.0;
+    const double C = std::floor((B - 122.1)/365.25);
+    const double D = std::floor(365.25*C);
+    const double E = std::floor((B - D)/30.6001);
+    const int day = (int)(B - D - std::floor(30.6001*E));
+    const int month = (int)(E < 14.0 ? E - 1.0 : E - 13.0);
+    // Date fields clamped so they fit their width (and the buffer) for any jd.
+    const int year = std::clamp((int)(month > 2 ? C - 4716.0 : C - 4715.0), -9999, 9999);
+    const int mon = std::clamp(month, 1, 12), dom = std::clamp(day, 1, 31);
+    char buf[32];
+    if(seconds)
+        std::snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02dZ", year, mon, dom, t/3600, (t/60)%60, t%60);
+    else
+        std::snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02dZ", year, mon, dom, t/60, t%60);
+    return buf;
+}
@@ -0,0 +1,196 @@
+#include "orbit/collision.hpp"
+#include "core/parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Chan's series replaces the disc by an equal-area circle in the
+// sigma-scaled plane. Its relative error is estimated as
+// 0.25 (R/s_min)^2 (1 + v/2) (1 - s_min^2/s_maj^2), v the squared miss in
+// sigmas; auto takes the series while that is under PC_SERIES_MAX_ERR.
+// Checked against quadrature (aspect to 1000, misses to 20 sigma), the
+// series' error stayed under 1e-3 wherever the estimate was.
+static constexpr double PC_SERIES_ERR_COEF = 0.25;
+static constexpr double PC_SERIES_MAX_ERR = 1e-3;
+static constexpr double PC_SERIES_TAIL_SWITCH = 1e-3;
+static constexpr int PC_SERIES_MAX_TERMS = 2000;
+static constexpr double PC_INTEGRATE_SIGMAS = 8.0;      // quadrature clipped to +-8 sigma
+static constexpr double PC_INTEGRATE_REL_TOL = 1e-7;
+static constexpr double PC_INTEGRATE_ABS_TOL = 1e-25;   // on Pc
+static constexpr int PC_INTEGRATE_PANELS = 32;
+static constexpr int PC_INTEGRATE_MAX_DEPTH = 20;
+static constexpr size_t PC_BATCH_BLOCK = 256;
+
+bool pc_method_from_name(const char* name, PcMethod& out){
+    if(std::strcmp(name, "auto") == 0){ out = PC_AUTO; return true; }
+    if(std::strcmp(name, "series") == 0){ out = PC_SERIES; return true; }
+    if(std::strcmp(name, "integrate") == 0){ out = PC_INTEGRATE; return true; }
+    return false;
+}
+
+double pc_series(double mx, double mz, double sx, double sz, double R){
+    // Pc = e^{-v/2} sum_m (v/2)^m/m! Q_m, Q_m = P(Poisson(u/2) > m)
+    const double hu = 0.5*R*R/(sx*sz);
+    const double hv = 0.5*(mx*mx/(sx*sx) + mz*mz/(sz*sz));
+    double outer = std::exp(-hv);
+    double p = std::exp(-hu);         // Poisson(u/2) pmf at m
+    double q = 1.0 - p;
+    bool direct = false;
+    double pc = 0.0;
+    for(int m=0; m<PC_SERIES_MAX_TERMS; m++){
+        if(m > 0){
+            outer *= hv/m;
+            p *= hu/m;
+            q -= p;
+        }
+        // Once Q_m is small, 1 - sum cancels: sum the tail itself instead.
+        if(direct || q < PC_SERIES_TAIL_SWITCH){
+            direct = true;
+            double t = p*hu/(m + 1);
+            q = t;
+            for(int j=m+2; t > 1e-17*q; j++){ t *= hu/j; q += t; }
+        }
+        const double term = outer*q;
+        pc += term;
+        if(m > hv && term <= 1e-14*pc) break;
+    }
+    return pc;
+}
+
+// Gaussian in x (sigma sx about mx) times the probability that z falls in
+// the disc's chord at x; x = R sin(theta) removes the chord's square-root
+// endpoints.
+namespace {
+struct StripIntegrand{
+    double mx, mz, sx, sz, R;
+    double operator()(double th) const {
+        const double x = R*std::sin(th), h = R*std::cos(th);
+        const double dx = (x - mx)/sx;
+        const double k = 1.0/(std::sqrt(2.0)*sz);
+        const double hi = (mz + h)*k, lo = (mz - h)*k;
+        // erfc differences in the tails, where erf - erf would cancel
+        const double p = lo > 0.0 ? 0.5*(std::erfc(lo) - std::erfc(hi))
+                       : hi < 0.0 ? 0.5*(std::erfc(-hi) - std::erfc(-lo))
+                       : 0.5*(std::erf(hi) - std::erf(lo));
+        return R*std::cos(th)*std::exp(-0.5*dx*dx)*p;
+    }
+};
+}
+
+static double adaptive_simpson(const StripIntegrand& f, double a, double b,
+                               double fa, double fm, double fb, double whole, double tol, int depth){
+    const double m = 0.5*(a + b);
+    const double lm = 0.5*(a + m), rm = 0.5*(m + b);
+    const double flm = f(lm), frm = f(rm);
+    const double left = (m - a)/6.0*(fa + 4.0*flm + fm);
+    const double right = (b - m)/6.0*(fm + 4.0*frm + fb);
+    const double d = left + right - whole;
+    if(depth <= 0 || std::fabs(d) <= 15.0*tol) return left + right + d/15.0;
+    return adaptive_simpson(f, a, m, fa, flm, fm, left, 0.5*tol, depth - 1)
+         + adaptive_simpson(f, m, b, fm, frm, fb, right, 0.5*tol, depth - 1);
+}
+
+double pc_integrate(double mx, double mz, double sx, double sz, double R){
+    // Integrate along the wider axis; the erf takes the narrow one exactly.
+    if(sx < sz){ std::swap(mx, mz); std::swap(sx, sz); }
+    // Clipped about the disc point nearest the mean, not the mean itself,
+    // so a disc lying beyond the clip distance is still integrated.
+    const double c = std::clamp(mx, -R, R);
+    const double lo = std::max(-R, c - PC_INTEGRATE_SIGMAS*sx);
+    const double hi = std::min(R, c + PC_INTEGRATE_SIGMAS*sx);
+    if(!(lo < hi)) return 0.0;
+    const StripIntegrand f{mx, mz, sx, sz, R};
+    const double a = std::asin(lo/R), b = std::asin(hi/R);
+    // Composite Simpson over fixed panels (each under a sigma of x) sets
+    // the scale; each panel is then refined to a share of the tolerance.
+    const double w = (b - a)/PC_INTEGRATE_PANELS;
+    double fl[PC_INTEGRATE_PANELS + 1], fm[PC_INTEGRATE_PANELS], whole[PC_INTEGRATE_PANELS];
+    double est = 0.0;
+    for(int k=0;k<=PC_INTEGRATE_PANELS;k++) fl[k] = f(a + k*w);
+    for(int k=0;k<PC_INTEGRATE_PANELS;k++){
+        fm[k] = f(a + (k + 0.5)*w);
+        whole[k] = w/6.0*(fl[k] + 4.0*fm[k] + fl[k+1]);
+        est += whole[k];
+    }
+    const double tol = std::max(PC_INTEGRATE_REL_TOL*std::fabs(est),
+                                PC_INTEGRATE_ABS_TOL*std::sqrt(2.0*M_PI)*sx)/PC_INTEGRATE_PANELS;
+    double I = 0.0;
+    for(int k=0;k<PC_INTEGRATE_PANELS;k++)
+        I += adaptive_simpson(f, a + k*w, a + (k + 1)*w, fl[k], fm[k], fl[k+1], whole[k], tol,
+                              PC_INTEGRATE_MAX_DEPTH);
+    return std::max(0.0, I/(std::sqrt(2.0*M_PI)*sx));
+}
+
+PcResult collision_probability(const ConjunctionEvent& ev, PcMethod method){
+    PcResult res;
+    const double* r = ev.r;
+    const double* v = ev.v;
+    const double vn = std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+    res.miss_km = std::sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+    if(!(vn > 0.0) || !(ev.hbr_km > 0.0)) return res;
+
+    // Encounter plane: y along the relative velocity, x toward the miss.
+    const double y[3] = {v[0]/vn, v[1]/vn, v[2]/vn};
+    const double ry = r[0]*y[0] + r[1]*y[1] + r[2]*y[2];
+    double x[3] = {r[0] - ry*y[0], r[1] - ry*y[1], r[2] - ry*y[2]};
+    double xn = std::sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]);
+    if(!(xn > 1e-12*std::max(1.0, res.miss_km))){
+        // head-on through the centre: any normal to y
+        const int k = std::fabs(y[0]) < 0.9 ? 0 : 1;
+        x[0] = (k == 0) - y[k]*y[0];
+        x[1] = (k == 1) - y[k]*y[1];
+        x[2] = -y[k]*y[2];
+        xn = std::sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]);
+    }
+    for(int k=0;k<3;k++) x[k] /= xn;
+    const double z[3] = {y[1]*x[2] - y[2]*x[1], y[2]*x[0] - y[0]*x[2], y[0]*x[1] - y[1]*x[0]};
+
+    double C[3][3];
+    const int ij[6][2] = {{0,0},{0,1},{0,2},{1,1},{1,2},{2,2}};
+    for(int k=0;k<6;k++){
+        const double c = ev.c1[k] + ev.c2[k];
+        C[ij[k][0]][ij[k][1]] = c;
+        C[ij[k][1]][ij[k][0]] = c;
+    }
+    auto quad = [&](const double* a, const double* b){
+        double s = 0.0;
+        for(int i=0;i<3;i++) for(int j=0;j<3;j++) s += a[i]*C[i][j]*b[j];
+        return s;
+    };
+    const double cxx = quad(x, x), cxz = quad(x, z), czz = quad(z, z);
+    const double mx0 = r[0]*x[0] + r[1]*x[1] + r[2]*x[2];
+    const double mz0 = r[0]*z[0] + r[1]*z[1] + r[2]*z[2];
+
+    // principal axes of the 2x2 covariance
+    const double th = 0.5*std::atan2(2.0*cxz, cxx - czz);
+    const double c = std::cos(th), s = std::sin(th);
+    const double l1 = c*c*cxx + 2.0*c*s*cxz + s*s*czz;
+    const double l2 = s*s*cxx - 2.0*c*s*cxz + c*c*czz;
+    if(!(l1 > 0.0) || !(l2 > 0.0)) return res;
+    const double s1 = std::sqrt(l1), s2 = std::sqrt(l2);
+    const double m1 = c*mx0 + s*mz0, m2 = -s*mx0 + c*mz0;
+    res.sigma_major_km = std::max(s1, s2);
+    res.sigma_minor_km = std::min(s1, s2);
+
+    if(method == PC_AUTO){
+        const double rs = ev.hbr_km/res.sigma_minor_km;
+        const double v = m1*m1/l1 + m2*m2/l2;
+        const double flat = 1.0 - (res.sigma_minor_km*res.sigma_minor_km)/(res.sigma_major_km*res.sigma_major_km);
+        const double err = PC_SERIES_ERR_COEF*rs*rs*(1.0 + 0.5*v)*flat;
+        method = err <= PC_SERIES_MAX_ERR ? PC_SERIES : PC_INTEGRATE;
+    }
+    res.pc = method == PC_SERIES ? pc_series(m1, m2, s1, s2, ev.hbr_km)
+                                 : pc_integrate(m1, m2, s1, s2, ev.hbr_km);
+    res.method = method;
+    res.ok = std::isfinite(res.pc);
+    return res;
+}
+
+void collision_probability_batch(size_t n, const ConjunctionEvent* ev, PcResult* out,
+                                 PcMethod method, size_t threads){
+    const size_t blocks = (n + PC_BATCH_BLOCK - 1)/PC_BATCH_BLOCK;
+    work_stealing_for(blocks, threads, [&](size_t b){
+        const size_t end = std::min(n, (b + 1)*PC_BATCH_BLOCK);
+        for(size_t i=b*PC_BATCH_BLOCK;i<end;i++) out[i] = collision_probability(ev[i], method);
+    });
+}
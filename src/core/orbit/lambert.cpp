@@ -1,6 +1,8 @@
 #include "orbit/lambert.hpp"
+#include "orbit/relative.hpp"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 static inline double stumpff_C(double z){
     if(z >  1e-12) return (1.0 - std::cos(std::sqrt(z))) / z;
@@ -22,90 +24,115 @@ static inline double norm3(const std::array<double,3>& a){
     return std::sqrt(std::max(0.0, dot3(a,a)));
 }
 
-static LambertSolution lambert_uv_single(const std::array<double,3>& r1,
-                                         const std::array<double,3>& r2,
-                                         double tof_s,
-                                         double mu_km3_s2,
-                                         int k_rev)
-{
-    const double r1m = norm3(r1);
-    const double r2m = norm3(r2);
-
-    double cos_dnu = dot3(r1,r2) / (r1m*r2m);
-    cos_dnu = std::clamp(cos_dnu, -1.0, 1.0);
-
-    const double TWO_PI = 2.0 * M_PI;
-    const double dnu = std::acos(cos_dnu) + TWO_PI * (double)k_rev;
-
-    const double sin_dnu = std::sin(dnu);
-    const double one_minus_cos = 1.0 - std::cos(dnu);
-
-    LambertSolution sol{};
-    if(std::abs(one_minus_cos) < 1e-12){
-        sol.v1_km_s = {0,0,0};
-        sol.v2_km_s = {0,0,0};
-        return sol;
+// Universal-variable Lambert (Bate, Mueller & White): time of flight as a
+// function of z, the square of the change in generalized anomaly. Single
+// revolution lives on z < (2 pi)^2, where the time rises with z; revolution
+// k on ((2 pi k)^2, (2 pi (k+1))^2), where it falls to a minimum and rises
+// again, giving a left and a right solution.
+struct UvGeometry{
+    double r1m, r2m, A, mu;
+    double y(double z) const {
+        return r1m + r2m + A*(z*stumpff_S(z) - 1.0)/std::sqrt(std::max(1e-300, stumpff_C(z)));
     }
-
-    const double A = sin_dnu * std::sqrt((r1m*r2m)/one_minus_cos);
-
-    // Solve for z (universal variable) using a robust bracket + relaxed Newton
-    double z = 0.0;
-    double z_lo = -4.0*M_PI*M_PI;
-    double z_hi =  4.0*M_PI*M_PI;
-
-    auto time_of_flight = [&](double zz)->double{
-        const double C = stumpff_C(zz);
-        const double S = stumpff_S(zz);
-
-        const double sqrtC = std::sqrt(std::max(1e-16, C));
-        const double y = r1m + r2m + A*(zz*S - 1.0)/sqrtC;
-        if(y < 0.0) return std::numeric_limits<double>::infinity();
-
-        const double x = std::sqrt(y / C);
-        return (x*x*x*S + A*std::sqrt(y)) / std::sqrt(mu_km3_s2);
-    };
-
-    // bracket target tof
-    for(int i=0;i<60;i++){
-        const double t_lo = time_of_flight(z_lo);
-        const double t_hi = time_of_flight(z_hi);
-        if(std::isfinite(t_lo) && std::isfinite(t_hi) && t_lo <= tof_s && tof_s <= t_hi) break;
-        z_lo *= 1.4;
-        z_hi *= 1.4;
+    // Negative y only happens for hyperbolic z below the smallest usable
+    // value, where the flight time has already reached zero.
+    double time_of_flight(double z) const {
+        const double yy = y(z);
+        if(yy < 0.0) return 0.0;
+        const double x = std::sqrt(yy/stumpff_C(z));
+        return (x*x*x*stumpff_S(z) + A*std::sqrt(yy))/std::sqrt(mu);
     }
+};
+
+// Bisection for the z in [lo, hi] with the requested time, rising is the
+// sense of the time over the bracket.
+static double uv_solve(const UvGeometry& g, double tof_s, double lo, double hi, bool rising){
+    for(int i=0;i<200;i++){
+        const double z = 0.5*(lo + hi);
+        if(z <= lo || z >= hi) break;
+        const double t = g.time_of_flight(z);
+        if(std::abs(t - tof_s) <= 1e-12*tof_s) return z;
+        if((t < tof_s) == rising) lo = z; else hi = z;
+    }
+    return 0.5*(lo + hi);
+}
 
-    // binary + relaxed Newton steps
-    for(int i=0;i<80;i++){
-        const double t = time_of_flight(z);
-        if(!std::isfinite(t)){
-            z = 0.5*(z + z_hi);
-            continue;
-        }
-        const double err = t - tof_s;
-        if(std::abs(err) < 1e-6) break;
-
-        if(err > 0) z_hi = z; else z_lo = z;
-
-        // relaxed step toward bracket mid
-        const double mid = 0.5*(z_lo + z_hi);
-        z = 0.7*z + 0.3*mid;
+static LambertSolution uv_velocities(const UvGeometry& g,
+                                     const std::array<double,3>& r1,
+                                     const std::array<double,3>& r2,
+                                     double z)
+{
+    const double y = g.y(z);
+    const double f = 1.0 - y/g.r1m;
+    const double gg = g.A*std::sqrt(y/g.mu);
+    const double gdot = 1.0 - y/g.r2m;
+    LambertSolution sol;
+    for(int i=0;i<3;i++){
+        sol.v1_km_s[i] = (r2[i] - f*r1[i])/gg;
+        sol.v2_km_s[i] = (gdot*r2[i] - r1[i])/gg;
     }
+    return sol;
+}
 
-    const double C = stumpff_C(z);
-    const double S = stumpff_S(z);
-    const double sqrtC = std::sqrt(std::max(1e-16, C));
-    const double y = r1m + r2m + A*(z*S - 1.0)/sqrtC;
+static std::vector<LambertSolution> lambert_uv(const std::array<double,3>& r1,
+                                               const std::array<double,3>& r2,
+                                               double tof_s,
+                                               double mu_km3_s2,
+                                               int max_rev,
+                                               bool retrograde)
+{
+    std::vector<LambertSolution> out;
+    UvGeometry g;
+    g.r1m = norm3(r1);
+    g.r2m = norm3(r2);
+    g.mu = mu_km3_s2;
+    if(!(tof_s > 0.0) || g.r1m == 0.0 || g.r2m == 0.0) return out;
 
-    const double f = 1.0 - y/r1m;
-    const double g = A * std::sqrt(y/mu_km3_s2);
-    const double gdot = 1.0 - y/r2m;
+    double cos_dnu = dot3(r1,r2) / (g.r1m*g.r2m);
+    cos_dnu = std::clamp(cos_dnu, -1.0, 1.0);
 
-    for(int i=0;i<3;i++){
-        sol.v1_km_s[i] = (r2[i] - f*r1[i]) / g;
-        sol.v2_km_s[i] = (gdot*r2[i] - r1[i]) / g;
+    // Long way round when the short arc runs against the requested sense.
+    const double TWO_PI = 2.0 * M_PI;
+    const double hz = r1[0]*r2[1] - r1[1]*r2[0];
+    const double short_way = std::acos(cos_dnu);
+    const double dnu = (hz < 0.0) != retrograde ? TWO_PI - short_way : short_way;
+
+    // 0 or 180 deg: the transfer plane is undefined.
+    if(std::abs(1.0 - cos_dnu) < 1e-12 || std::abs(1.0 + cos_dnu) < 1e-12) return out;
+    g.A = std::sin(dnu) * std::sqrt(g.r1m*g.r2m/(1.0 - cos_dnu));
+
+    // Single revolution: push the lower end out until it is early enough.
+    double lo = -4.0*M_PI*M_PI;
+    for(int i=0;i<200 && g.time_of_flight(lo) > tof_s;i++) lo *= 2.0;
+    const double z0 = uv_solve(g, tof_s, lo, TWO_PI*TWO_PI, true);
+    out.push_back(uv_velocities(g, r1, r2, z0));
+
+    // Multi-revolution: golden-section search for the minimum time, then
+    // a solution on each side if the requested time reaches it, larger z
+    // first to match lambert_izzo's left/right order. The minimum grows
+    // with k, so the first infeasible k ends the search.
+    const double INV_PHI = 0.5*(std::sqrt(5.0) - 1.0);
+    for(int k=1;k<=max_rev;k++){
+        const double a = TWO_PI*k*TWO_PI*k, b = TWO_PI*(k+1)*TWO_PI*(k+1);
+        double l = a, h = b;
+        double c = h - INV_PHI*(h - l), d = l + INV_PHI*(h - l);
+        double tc = g.time_of_flight(c), td = g.time_of_flight(d);
+        for(int i=0;i<100 && h - l > 1e-12*b;i++){
+            if(tc < td){ h = d; d = c; td = tc; c = h - INV_PHI*(h - l); tc = g.time_of_flight(c); }
+            else{ l = c; c = d; tc = td; d = l + INV_PHI*(h - l); td = g.time_of_flight(d); }
+        }
+        const double z_min = 0.5*(l + h);
+        if(g.time_of_flight(z_min) > tof_s) break;
+        out.push_back(uv_velocities(g, r1, r2, uv_solve(g, tof_s, z_min, b, true)));
+        out.push_back(uv_velocities(g, r1, r2, uv_solve(g, tof_s, a, z_min, false)));
     }
-    return sol;
+    return out;
+}
+
+bool lambert_method_from_name(const std::string& name, LambertMethod& m){
+    if(name == "uv"){ m = LAMBERT_UNIVERSAL; return true; }
+    if(name == "izzo"){ m = LAMBERT_IZZO; return true; }
+    return false;
 }
 
 std::vector<LambertSolution>
@@ -113,14 +140,55 @@ lambert_intercept(const std::array<double,3>& r1,
                   const std::array<double,3>& r2,
                   double tof_s,
                   double mu_km3_s2,
-                  int max_rev)
+                  int max_rev,
+                  LambertMethod method,
+                  bool retrograde)
 {
-    std::vector<LambertSolution> out;
-    max_rev = std::max(0, max_rev);
-    for(int k=0;k<=max_rev;k++){
-        out.push_back(lambert_uv_single(r1,r2,tof_s,mu_km3_s2,k));
+    if(method == LAMBERT_IZZO) return lambert_izzo(r1,r2,tof_s,mu_km3_s2,max_rev,retrograde);
+    return lambert_uv(r1,r2,tof_s,mu_km3_s2,max_rev,retrograde);
+}
+
+static inline double dv_between(const std::array<double,3>& a, const std::array<double,3>& b){
+    const std::array<double,3> d = {a[0]-b[0], a[1]-b[1], a[2]-b[2]};
+    return norm3(d);
+}
+
+LambertSolution pick_min_dv1(const std::vector<LambertSolution>& sols,
+                             const std::array<double,3>& v_now_km_s)
+{
+    if(sols.empty()){
+        return LambertSolution{{NAN,NAN,NAN},{NAN,NAN,NAN}};
     }
-    return out;
+    double best = std::numeric_limits<double>::infinity();
+    size_t best_i = 0;
+    for(size_t i=0;i<sols.size();++i){
+        double m = dv_between(sols[i].v1_km_s, v_now_km_s);
+        if(std::isfinite(m) && m < best){
+            best = m;
+            best_i = i;
+        }
+    }
+    return sols[best_i];
+}
+
+size_t pick_min_dv_total(const std::vector<LambertSolution>& sols,
+                         const std::array<double,3>& v_now_km_s,
+                         const std::array<double,3>& v_target_km_s,
+                         double& dv1_km_s, double& dv2_km_s)
+{
+    double best = std::numeric_limits<double>::infinity();
+    size_t best_i = sols.size();
+    for(size_t i=0;i<sols.size();++i){
+        const double d1 = dv_between(sols[i].v1_km_s, v_now_km_s);
+        const double d2 = dv_between(v_target_km_s, sols[i].v2_km_s);
+        if(std::isfinite(d1 + d2) && d1 + d2 < best){
+            best = d1 + d2;
+            best_i = i;
+            dv1_km_s = d1;
+            dv2_km_s = d2;
+        }
+    }
+    return best_i;
 }
 
 std::vector<LambertSolution>
@@ -129,9 +197,10 @@ lambert_rendezvous(const std::array<double,3>& r1,
                    const std::array<double,3>& r2,
                    double tof_s,
                    double mu_km3_s2,
-                   int max_rev)
+                   int max_rev,
+                   LambertMethod method)
 {
-    auto out = lambert_intercept(r1,r2,tof_s,mu_km3_s2,max_rev);
+    auto out = lambert_intercept(r1,r2,tof_s,mu_km3_s2,max_rev,method);
     for(auto& s : out){
         s.v2_km_s = v_target_km_s; // terminal velocity match burn
     }
@@ -147,72 +216,14 @@ lambert_nmc(const std::array<double,3>& r1,
             const NMCParams& nmc,
             double mu_km3_s2)
 {
-    auto dot3 = [](const std::array<double,3>& a, const std::array<double,3>& b){
-        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
-    };
-    auto cross3 = [](const std::array<double,3>& a, const std::array<double,3>& b){
-        return std::array<double,3>{
-            a[1]*b[2] - a[2]*b[1],
-            a[2]*b[0] - a[0]*b[2],
-            a[0]*b[1] - a[1]*b[0]
-        };
-    };
-    auto norm3 = [&](const std::array<double,3>& a){
-        const double n2 = dot3(a,a);
-        return std::sqrt(std::max(0.0, n2));
-    };
-    auto scale3 = [](const std::array<double,3>& a, double k){
-        return std::array<double,3>{a[0]*k, a[1]*k, a[2]*k};
-    };
-    auto add3 = [](const std::array<double,3>& a, const std::array<double,3>& b){
-        return std::array<double,3>{a[0]+b[0], a[1]+b[1], a[2]+b[2]};
-    };
-    auto unit3_or = [&](const std::array<double,3>& a, const std::array<double,3>& fb){
-        const double n = norm3(a);
-        if(n < 1e-12) return fb;
-        return scale3(a, 1.0/n);
-    };
-
-    // Target LVLH basis at arrival (R/I/C)
-    const auto eR = unit3_or(r2_target, {1,0,0});
-    const auto h  = cross3(r2_target, v2_target);
-    const auto eC = unit3_or(h, {0,0,1});
-    const auto eI = unit3_or(cross3(eC, eR), {0,1,0});
-
-    // Angular rate vector of LVLH frame: omega = h / r^2 (rad/s)
-    const double rmag = std::max(1e-12, norm3(r2_target));
-    const double r2   = rmag*rmag;
-    const auto omega  = scale3(h, 1.0/r2);
-    const double n    = norm3(omega); // mean-ish rate for CW-like NMC sizing
-
-    // NMC: "2x1 ellipse" in (R,I) plane, size parameter is semi-minor axis b (closest approach)
-    // Choose a=2b (semi-major in-track), param theta (entry angle).
-    const double b_km = std::max(1e-9, nmc.semi_minor_km);
-    const double a_km = 2.0*b_km;
-    const double th   = nmc.entry_angle_deg * (3.14159265358979323846/180.0);
-
-    // Relative position in LVLH (km)
-    // x_R = b cos(th), y_I = a sin(th), z_C = 0
-    const double xR = b_km * std::cos(th);
-    const double yI = a_km * std::sin(th);
-    const double zC = 0.0;
-
-    // Relative velocity in LVLH rotating frame (km/s) for the parametric ellipse
-    // xdot = -b n sin(th), ydot =  a n cos(th)
-    const double xRdot = -b_km * n * std::sin(th);
-    const double yIdot =  a_km * n * std::cos(th);
-    const double zCdot = 0.0;
-
-    // Convert LVLH-relative position to ECI
-    const auto r_rel_eci = add3(add3(scale3(eR, xR), scale3(eI, yI)), scale3(eC, zC));
-    const auto r2_des    = add3(r2_target, r_rel_eci);
-
-    // Convert LVLH-relative velocity to ECI:
-    // v_rel_eci = (xdot*eR + ydot*eI + zdot*eC) + omega x r_rel_eci
-    const auto v_rel_basis = add3(add3(scale3(eR, xRdot), scale3(eI, yIdot)), scale3(eC, zCdot));
-    const auto omega_x_r   = cross3(omega, r_rel_eci);
-    const auto v_rel_eci   = add3(v_rel_basis, omega_x_r);
-    const auto v2_des      = add3(v2_target, v_rel_eci);
+    // Target LVLH (R/I/C) frame at arrival; the NMC insertion point is the
+    // drift-free CW ellipse entered at the requested angle, so the
+    // chaser stays on it without further burns.
+    const RicFrame f = ric_frame(r2_target, v2_target, mu_km3_s2);
+    double rel[6];
+    cw_nmc_state(std::max(1e-9, nmc.semi_minor_km), nmc.entry_angle_deg*(M_PI/180.0), f.n, rel);
+    std::array<double,3> r2_des, v2_des;
+    ric_to_eci(f, rel, r2_des, v2_des);
 
     // Solve as "rendezvous to state": arrive at r2_des with v2_des at tof.
     // NOTE: we ignore multi-rev here (NMC sizing is already tied to local motion); caller can sweep if needed.
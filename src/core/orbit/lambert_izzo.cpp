@@ -0,0 +1,236 @@
+#include "orbit/lambert.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Izzo, "Revisiting Lambert's problem" (CMDA 2015). The transfer is solved
+// in one non-dimensional variable x (x < 1 ellipse, x > 1 hyperbola) whose
+// time-of-flight curve T(x) is smooth enough for third-order Householder
+// steps; with the paper's initial guesses 2-4 iterations reach 1e-11.
+
+static constexpr double HOUSEHOLDER_TOL = 1e-11;
+static constexpr int HOUSEHOLDER_MAX_ITERS = 15;
+static constexpr int HALLEY_MAX_ITERS = 12;
+static constexpr double BATTIN_DIST = 0.01;    // |x-1| below: series form
+static constexpr double LAGRANGE_DIST = 0.2;   // |x-1| below: Lagrange form
+
+static inline std::array<double,3> cross3(const std::array<double,3>& a, const std::array<double,3>& b){
+    return {a[1]*b[2] - a[2]*b[1], a[2]*b[0] - a[0]*b[2], a[0]*b[1] - a[1]*b[0]};
+}
+
+static inline double norm3(const std::array<double,3>& a){
+    return std::sqrt(a[0]*a[0] + a[1]*a[1] + a[2]*a[2]);
+}
+
+// 2F1(3, 1; 5/2; z) for Battin's near-parabolic series.
+static double hypergeometric_f(double z){
+    double sj = 1.0, cj = 1.0;
+    for(int j=0;j<1000;j++){
+        cj *= (3.0 + j)*(1.0 + j)/(2.5 + j)*z/(j + 1.0);
+        sj += cj;
+        if(std::fabs(cj) < 1e-11) break;
+    }
+    return sj;
+}
+
+struct IzzoGeometry{
+    double lam, lam2, lam3;
+};
+
+// Lagrange's expression, used away from x = 1.
+static double x2tof_lagrange(const IzzoGeometry& g, double x, int n){
+    const double a = 1.0/(1.0 - x*x);
+    if(a > 0.0){
+        const double alfa = 2.0*std::acos(x);
+        double beta = 2.0*std::asin(std::sqrt(g.lam2/a));
+        if(g.lam < 0.0) beta = -beta;
+        return a*std::sqrt(a)*((alfa - std::sin(alfa)) - (beta - std::sin(beta)) + 2.0*M_PI*n)/2.0;
+    }
+    const double alfa = 2.0*std::acosh(x);
+    double beta = 2.0*std::asinh(std::sqrt(-g.lam2/a));
+    if(g.lam < 0.0) beta = -beta;
+    return -a*std::sqrt(-a)*((beta - std::sinh(beta)) - (alfa - std::sinh(alfa)))/2.0;
+}
+
+// Non-dimensional time of flight T(x) on the n-revolution branch.
+static double x2tof(const IzzoGeometry& g, double x, int n){
+    const double dist = std::fabs(x - 1.0);
+    if(dist < LAGRANGE_DIST && dist > BATTIN_DIST) return x2tof_lagrange(g, x, n);
+    const double E = x*x - 1.0;
+    const double rho = std::fabs(E);
+    const double z = std::sqrt(1.0 + g.lam2*E);
+    if(dist < BATTIN_DIST){
+        const double eta = z - g.lam*x;
+        const double s1 = 0.5*(1.0 - g.lam - x*eta);
+        const double q = 4.0/3.0*hypergeometric_f(s1);
+        return (eta*eta*eta*q + 4.0*g.lam*eta)/2.0 + n*M_PI/std::pow(rho, 1.5);
+    }
+    const double y = std::sqrt(rho);
+    const double gg = x*z - g.lam*E;
+    double d;
+    if(E < 0.0) d = n*M_PI + std::acos(gg);
+    else d = std::log(y*(z - g.lam*x) + gg);
+    return (x - g.lam*z - d/y)/E;
+}
+
+// First three derivatives of T(x), given T at x.
+static void dtdx(const IzzoGeometry& g, double x, double T, double& dT, double& ddT, double& dddT){
+    const double umx2 = 1.0 - x*x;
+    const double y = std::sqrt(1.0 - g.lam2*umx2);
+    const double y2 = y*y, y3 = y2*y;
+    dT = (3.0*T*x - 2.0 + 2.0*g.lam3*x/y)/umx2;
+    ddT = (3.0*T + 5.0*x*dT + 2.0*(1.0 - g.lam2)*g.lam3/y3)/umx2;
+    dddT = (7.0*x*ddT + 8.0*dT - 6.0*(1.0 - g.lam2)*g.lam2*g.lam3*x/y3/y2)/umx2;
+}
+
+// Householder iterations from x0. `slope` receives dT/dx at the last
+// iterate; false if the step never fell below HOUSEHOLDER_TOL.
+static bool householder(const IzzoGeometry& g, double T, double& x0, int n, int& iters, double& slope){
+    for(int it=0;it<HOUSEHOLDER_MAX_ITERS;it++){
+        iters++;
+        const double tof = x2tof(g, x0, n);
+        double dT, ddT, dddT;
+        dtdx(g, x0, tof, dT, ddT, dddT);
+        const double delta = tof - T;
+        const double dT2 = dT*dT;
+        const double x = x0 - delta*(dT2 - delta*ddT/2.0)
+                              /(dT*(dT2 - delta*ddT) + dddT*delta*delta/6.0);
+        const double err = std::fabs(x0 - x);
+        x0 = x;
+        slope = dT;
+        if(err <= HOUSEHOLDER_TOL) return true;
+    }
+    return false;
+}
+
+// Largest revolution count reachable in T: the n-rev branch exists only
+// above its minimum time, located by Halley iterations on dT/dx = 0.
+static int max_revolutions(const IzzoGeometry& g, double T){
+    int m = (int)(T/M_PI);
+    if(m == 0) return 0;
+    const double t00 = std::acos(g.lam) + g.lam*std::sqrt(1.0 - g.lam2);
+    const double t0 = t00 + m*M_PI;
+    if(T >= t0) return m;
+    double x_old = 0.0, t_min = t0;
+    for(int it=0;it<HALLEY_MAX_ITERS;it++){
+        double dT, ddT, dddT;
+        dtdx(g, x_old, t_min, dT, ddT, dddT);
+        if(dT == 0.0) break;
+        const double x_new = x_old - dT*ddT/(ddT*ddT - dT*dddT/2.0);
+        const double err = std::fabs(x_old - x_new);
+        t_min = x2tof(g, x_new, m);
+        x_old = x_new;
+        if(err < 1e-13) break;
+    }
+    return t_min > T ? m - 1 : m;
+}
+
+std::vector<LambertSolution>
+lambert_izzo(const std::array<double,3>& r1,
+             const std::array<double,3>& r2,
+             double tof_s,
+             double mu_km3_s2,
+             int max_rev,
+             bool retrograde,
+             LambertWarmStart* warm)
+{
+    std::vector<LambertSolution> out;
+    const std::array<double,3> c = {r2[0] - r1[0], r2[1] - r1[1], r2[2] - r1[2]};
+    const double cn = norm3(c), r1n = norm3(r1), r2n = norm3(r2);
+    if(!(tof_s > 0.0) || cn == 0.0 || r1n == 0.0 || r2n == 0.0) return out;
+    const double s = 0.5*(r1n + r2n + cn);
+
+    const std::array<double,3> ir1 = {r1[0]/r1n, r1[1]/r1n, r1[2]/r1n};
+    const std::array<double,3> ir2 = {r2[0]/r2n, r2[1]/r2n, r2[2]/r2n};
+    std::array<double,3> ih = cross3(ir1, ir2);
+    const double hn = norm3(ih);
+    if(hn < 1e-12) return out;  // 0 or 180 deg: transfer plane undefined
+    for(double& v : ih) v /= hn;
+
+    // Transfer direction about +z (the short or long way round).
+    IzzoGeometry g;
+    g.lam2 = 1.0 - cn/s;
+    g.lam = std::sqrt(std::max(0.0, g.lam2));
+    std::array<double,3> it1, it2;
+    if(ih[2] < 0.0){
+        g.lam = -g.lam;
+        it1 = cross3(ir1, ih);
+        it2 = cross3(ir2, ih);
+    }else{
+        it1 = cross3(ih, ir1);
+        it2 = cross3(ih, ir2);
+    }
+    if(retrograde){
+        g.lam = -g.lam;
+        for(int k=0;k<3;k++){ it1[k] = -it1[k]; it2[k] = -it2[k]; }
+    }
+    g.lam3 = g.lam2*g.lam;
+    const double T = std::sqrt(2.0*mu_km3_s2/(s*s*s))*tof_s;
+
+    // Solutions in x: single revolution, then left/right per revolution.
+    // A warm start replaces the paper's guess branch by branch, and is
+    // dropped if it converges off its branch.
+    // A branch whose seed is rejected is marked NaN, so the next solve
+    // starts it cold and then rebuilds its extrapolation.
+    std::vector<double> xs, seeded;
+    int iters = 0;
+    auto solve = [&](double x0, int n, int side){
+        const size_t b = xs.size();
+        double slope;
+        if(warm && b < warm->x.size() && std::isfinite(warm->x[b])){
+            double x = warm->x[b];
+            if(b < warm->x_prev.size() && std::isfinite(warm->x_prev[b])) x = 2.0*x - warm->x_prev[b];
+            // Kept only if it converged inside the domain with T falling
+            // (single rev, left) or rising (right) in x, i.e. on its branch.
+            if(householder(g, T, x, n, iters, slope)
+               && x > -1.0 && (n == 0 || x < 1.0) && side*slope >= 0.0){
+                xs.push_back(x);
+                seeded.push_back(x);
+                return;
+            }
+            householder(g, T, x0, n, iters, slope);
+            xs.push_back(x0);
+            seeded.push_back(NAN);
+            return;
+        }
+        householder(g, T, x0, n, iters, slope);
+        xs.push_back(x0);
+        seeded.push_back(x0);
+    };
+    const double t00 = std::acos(g.lam) + g.lam*std::sqrt(1.0 - g.lam2);
+    const double t1 = 2.0/3.0*(1.0 - g.lam3);
+    double x0;
+    if(T >= t00) x0 = -(T - t00)/(T - t00 + 4.0);
+    else if(T <= t1) x0 = t1*(t1 - T)/(2.0/5.0*(1.0 - g.lam2*g.lam3)*T) + 1.0;
+    else x0 = std::pow(T/t00, std::log(2.0)/std::log(t1/t00)) - 1.0;
+    solve(x0, 0, 0);
+
+    const int m = std::min(std::max(0, max_rev), max_revolutions(g, T));
+    for(int n=1;n<=m;n++){
+        double tmp = std::pow((n*M_PI + M_PI)/(8.0*T), 2.0/3.0);
+        solve((tmp - 1.0)/(tmp + 1.0), n, -1);
+        tmp = std::pow(8.0*T/(n*M_PI), 2.0/3.0);
+        solve((tmp - 1.0)/(tmp + 1.0), n, 1);
+    }
+
+    const double gamma = std::sqrt(mu_km3_s2*s/2.0);
+    const double rho = (r1n - r2n)/cn;
+    const double sigma = std::sqrt(std::max(0.0, 1.0 - rho*rho));
+    for(double x : xs){
+        const double y = std::sqrt(1.0 - g.lam2 + g.lam2*x*x);
+        const double vr1 = gamma*((g.lam*y - x) - rho*(g.lam*y + x))/r1n;
+        const double vr2 = -gamma*((g.lam*y - x) + rho*(g.lam*y + x))/r2n;
+        const double vt = gamma*sigma*(y + g.lam*x);
+        LambertSolution sol;
+        for(int k=0;k<3;k++){
+            sol.v1_km_s[k] = vr1*ir1[k] + vt/r1n*it1[k];
+            sol.v2_km_s[k] = vr2*ir2[k] + vt/r2n*it2[k];
+        }
+        out.push_back(sol);
+    }
+    if(warm){
+        warm->x_prev = std::move(warm->x);
+        warm->x = std::move(seeded);
+        warm->iterations = iters;
+    }
+    return out;
+}
@@ -0,0 +1,181 @@
+#include "orbit/relative.hpp"
+#include <algorithm>
+#include <cmath>
+
+static constexpr double CW_CURVATURE_COEF = 1.5;
+static constexpr double CW_ECC_COEF = 3.0;
+
+static inline double dot3(const std::array<double,3>& a, const std::array<double,3>& b){
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+static inline std::array<double,3> cross3(const std::array<double,3>& a, const std::array<double,3>& b){
+    return {a[1]*b[2] - a[2]*b[1], a[2]*b[0] - a[0]*b[2], a[0]*b[1] - a[1]*b[0]};
+}
+
+static inline std::array<double,3> unit3(const std::array<double,3>& a){
+    const double n = std::sqrt(dot3(a, a));
+    return {a[0]/n, a[1]/n, a[2]/n};
+}
+
+RicFrame ric_frame(const std::array<double,3>& r, const std::array<double,3>& v, double mu_km3_s2){
+    RicFrame f;
+    f.r = r;
+    f.v = v;
+    f.rmag = std::sqrt(dot3(r, r));
+    const auto h = cross3(r, v);
+    f.eR = unit3(r);
+    f.eC = unit3(h);
+    f.eI = cross3(f.eC, f.eR);
+    f.w = std::sqrt(dot3(h, h))/(f.rmag*f.rmag);
+    const double v2 = dot3(v, v);
+    const double a = 1.0/(2.0/f.rmag - v2/mu_km3_s2);
+    f.n = a > 0.0 ? std::sqrt(mu_km3_s2/(a*a*a)) : f.w;
+    const double rv = dot3(r, v);
+    std::array<double,3> ev;
+    for(int k=0;k<3;k++) ev[k] = ((v2 - mu_km3_s2/f.rmag)*r[k] - rv*v[k])/mu_km3_s2;
+    f.e = std::sqrt(dot3(ev, ev));
+    return f;
+}
+
+void eci_to_ric(const RicFrame& f, const std::array<double,3>& r, const std::array<double,3>& v,
+                double rel[6]){
+    const std::array<double,3> dr = {r[0] - f.r[0], r[1] - f.r[1], r[2] - f.r[2]};
+    const std::array<double,3> dv = {v[0] - f.v[0], v[1] - f.v[1], v[2] - f.v[2]};
+    rel[0] = dot3(dr, f.eR); rel[1] = dot3(dr, f.eI); rel[2] = dot3(dr, f.eC);
+    // rotating-frame rate: subtract w x rho, w = w eC
+    rel[3] = dot3(dv, f.eR) + f.w*rel[1];
+    rel[4] = dot3(dv, f.eI) - f.w*rel[0];
+    rel[5] = dot3(dv, f.eC);
+}
+
+void ric_to_eci(const RicFrame& f, const double rel[6],
+                std::array<double,3>& r, std::array<double,3>& v){
+    const double vx = rel[3] - f.w*rel[1], vy = rel[4] + f.w*rel[0];
+    for(int k=0;k<3;k++){
+        r[k] = f.r[k] + rel[0]*f.eR[k] + rel[1]*f.eI[k] + rel[2]*f.eC[k];
+        v[k] = f.v[k] + vx*f.eR[k] + vy*f.eI[k] + rel[5]*f.eC[k];
+    }
+}
+
+void cw_stm(double n, double t, double phi[6][6]){
+    const double s = std::sin(n*t), c = std::cos(n*t), nt = n*t;
+    const double p[6][6] = {
+        {4.0 - 3.0*c,        0, 0,  s/n,             2.0*(1.0 - c)/n,     0},
+        {6.0*(s - nt),       1, 0, -2.0*(1.0 - c)/n, (4.0*s - 3.0*nt)/n,  0},
+        {0,                  0, c,  0,               0,                   s/n},
+        {3.0*n*s,            0, 0,  c,               2.0*s,               0},
+        {-6.0*n*(1.0 - c),   0, 0, -2.0*s,           4.0*c - 3.0,         0},
+        {0,                  0, -n*s, 0,             0,                   c},
+    };
+    std::copy(&p[0][0], &p[0][0] + 36, &phi[0][0]);
+}
+
+void cw_propagate(double n, double t, const double in[6], double out[6]){
+    cw_propagate_batch(n, t, 1, in, out);
+}
+
+void cw_propagate_batch(double n, double t, size_t m, const double* in, double* out){
+    double p[6][6];
+    cw_stm(n, t, p);
+    // The STM is block-sparse: in-plane (x, y, xd, yd) and cross-track (z, zd).
+    for(size_t i=0;i<m;i++){
+        const double* a = in + 6*i;
+        double* b = out + 6*i;
+        const double x = a[0], y = a[1], z = a[2], xd = a[3], yd = a[4], zd = a[5];
+        b[0] = p[0][0]*x + p[0][3]*xd + p[0][4]*yd;
+        b[1] = p[1][0]*x + y + p[1][3]*xd + p[1][4]*yd;
+        b[2] = p[2][2]*z + p[2][5]*zd;
+        b[3] = p[3][0]*x + p[3][3]*xd + p[3][4]*yd;
+        b[4] = p[4][0]*x + p[4][3]*xd + p[4][4]*yd;
+        b[5] = p[5][2]*z + p[5][5]*zd;
+    }
+}
+
+double cw_range_bound_km(double n, const double rel[6], double t){
+    const double xc = 4.0*rel[0] + 2.0*rel[4]/n;             // guiding centre, radial
+    const double yc0 = rel[1] - 2.0*rel[3]/n;                 // ... in-track at 0
+    const double yc1 = yc0 - 1.5*n*xc*t;                      // ... after drift
+    const double A = std::hypot(3.0*rel[0] + 2.0*rel[4]/n, rel[3]/n);
+    const double Z = std::hypot(rel[2], rel[5]/n);
+    const double x = std::fabs(xc) + A, y = std::max(std::fabs(yc0), std::fabs(yc1)) + 2.0*A;
+    return std::sqrt(x*x + y*y + Z*Z);
+}
+
+double cw_error_bound_km(const RicFrame& f, double rho_max_km, double t){
+    const double nt = f.n*std::fabs(t);
+    return rho_max_km*(CW_CURVATURE_COEF*(rho_max_km/f.rmag)*nt*nt + CW_ECC_COEF*f.e*(1.0 + nt));
+}
+
+bool kepler_propagate(const std::array<double,3>& r0, const std::array<double,3>& v0,
+                      double dt, double mu_km3_s2,
+                      std::array<double,3>& r, std::array<double,3>& v){
+    const double r0m = std::sqrt(dot3(r0, r0));
+    const double a = 1.0/(2.0/r0m - dot3(v0, v0)/mu_km3_s2);
+    if(!(a > 0.0)) return false;
+    // e cos E0, e sin E0, then Kepler's equation with M reduced to
+    // [-pi, pi] and the whole revolutions put back.
+    const double ec = 1.0 - r0m/a;
+    const double es = dot3(r0, v0)/std::sqrt(mu_km3_s2*a);
+    const double e = std::sqrt(ec*ec + es*es);
+    const double E0 = std::atan2(es, ec);
+    const double M1 = E0 - es + std::sqrt(mu_km3_s2/(a*a*a))*dt;
+    const double Mr = std::remainder(M1, 2.0*M_PI);
+    double E1 = e < 0.8 ? Mr : (Mr < 0.0 ? -M_PI : M_PI);
+    for(int it=0; it<60; it++){
+        const double d = (E1 - e*std::sin(E1) - Mr)/(1.0 - e*std::cos(E1));
+        E1 -= d;
+        if(std::fabs(d) < 1e-14) break;
+    }
+    const double dE = E1 + (M1 - Mr) - E0;
+    const double sd = std::sin(dE), cd = std::cos(dE);
+    const double rm = a + (r0m - a)*cd + es*a*sd;
+    const double f = 1.0 - a/r0m*(1.0 - cd);
+    const double g = dt + std::sqrt(a*a*a/mu_km3_s2)*(sd - dE);
+    const double fd = -std::sqrt(mu_km3_s2*a)/(rm*r0m)*sd;
+    const double gd = 1.0 - a/rm*(1.0 - cd);
+    for(int k=0;k<3;k++){
+        r[k] = f*r0[k] + g*v0[k];
+        v[k] = fd*r0[k] + gd*v0[k];
+    }
+    return true;
+}
+
+size_t relative_propagate(const RicFrame& f, double t, size_t m, const double* in, double* out,
+                          double tol_km, double mu_km3_s2){
+    cw_propagate_batch(f.n, t, m, in, out);
+
+    size_t fallbacks = 0;
+    RicFrame ft;
+    bool have_ft = false;
+    for(size_t i=0;i<m;i++){
+        const double* a = in + 6*i;
+        double* b = out + 6*i;
+        const double rho = cw_range_bound_km(f.n, a, t);
+        if(cw_error_bound_km(f, rho, t) <= tol_km) continue;
+
+        if(!have_ft){
+            std::array<double,3> rt, vt;
+            if(!kepler_propagate(f.r, f.v, t, mu_km3_s2, rt, vt)) return fallbacks;
+            ft = ric_frame(rt, vt, mu_km3_s2);
+            have_ft = true;
+        }
+        std::array<double,3> rc, vc, rc1, vc1;
+        ric_to_eci(f, a, rc, vc);
+        if(!kepler_propagate(rc, vc, t, mu_km3_s2, rc1, vc1)) continue;
+        eci_to_ric(ft, rc1, vc1, b);
+        fallbacks++;
+    }
+    return fallbacks;
+}
+
+void cw_nmc_state(double b_km, double theta, double n, double rel[6]){
+    // x = b cos(phi), y = -2 b sin(phi) with phi = n t - theta; drift-free
+    // because ydot = -2 n x.
+    rel[0] = b_km*std::cos(theta);
+    rel[1] = 2.0*b_km*std::sin(theta);
+    rel[2] = 0.0;
+    rel[3] = b_km*n*std::sin(theta);
+    rel[4] = -2.0*b_km*n*std::cos(theta);
+    rel[5] = 0.0;
+}
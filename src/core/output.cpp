@@ -1,11 +1,32 @@
 #include "core/output.hpp"
+#include "core/frames.hpp"
+#include <filesystem>
+#include <system_error>
 
 void OutputWriter::open(const std::string& path,double rate_s){
     out.open(path);
     rate=rate_s;
     next_t=0.0;
     is_on=true;
-    out<<"Time,EntityID,EntityName,X,Y,Z,VX,VY,VZ\n";
+    out<<"Time,EntityID,EntityName,X,Y,Z,VX,VY,VZ,LatDeg,LonDeg,AltKm\n";
+}
+
+bool OutputWriter::resume(const std::string& path,double rate_s,double next_t_s,uint64_t offset){
+    std::error_code ec;
+    std::filesystem::resize_file(path, offset, ec);
+    if(ec) return false;
+    out.open(path, std::ios::app);
+    if(!out) return false;
+    rate=rate_s;
+    next_t=next_t_s;
+    is_on=true;
+    return true;
+}
+
+uint64_t OutputWriter::position(){
+    if(!is_on) return 0;
+    out.flush();
+    return (uint64_t)out.tellp();
 }
 
 void OutputWriter::tick(double t,const PhysicsEngine& e){
@@ -13,9 +34,15 @@ void OutputWriter::tick(double t,const PhysicsEngine& e){
     if(t+1e-9 < next_t) return;
     next_t = t + rate;
 
-    for(size_t i=0;i<e.bodies.size();++i){
+    const size_t n=e.bodies.size();
+    lat.resize(n); lon.resize(n); alt.resize(n);
+    if(n) eci_to_lla_batch(e.epoch_jd + e.time/86400.0, n, &e.bodies[0].x, sizeof(Body)/sizeof(double),
+                           lat.data(), lon.data(), alt.data());
+
+    for(size_t i=0;i<n;++i){
         const auto& b=e.bodies[i];
         const char* name = (i<e.names.size()) ? e.names[i].c_str() : "";
-        out<<t<<","<<i<<","<<name<<","<<b.x<<","<<b.y<<","<<b.z<<","<<b.vx<<","<<b.vy<<","<<b.vz<<"\n";
+        out<<t<<","<<i<<","<<name<<","<<b.x<<","<<b.y<<","<<b.z<<","<<b.vx<<","<<b.vy<<","<<b.vz
+           <<","<<lat[i]<<","<<lon[i]<<","<<alt[i]<<"\n";
     }
 }
@@ -11,33 +11,71 @@ static double parse_double(const std::string& s){
     return std::stod(s);
 }
 
-bool load_tles_from_file(const std::string& path, std::vector<TLE>& out){
-    std::ifstream f(path);
-    if(!f) return false;
+// Assumed-decimal exponent field, e.g. " 12345-4" = 0.12345e-4.
+static double parse_tle_exp(const std::string& f){
+    if(f.size() < 8) return 0.0;
+    const double mant = parse_double("0." + f.substr(1,5));
+    const int ex = std::stoi(f.substr(6,2));
+    const double v = mant * std::pow(10.0, ex);
+    return f[0]=='-' ? -v : v;
+}
 
-    std::string line;
+// Julian date of 0h UTC on Jan 1 of `year` (Gregorian, 1901..2099).
+static double jd_jan1(int year){
+    const int y = year - 1;
+    return 1721425.5 + 365.0*y + y/4 - y/100 + y/400;
+}
+
+static void parse_tle_elements(TLE& t){
+    const std::string& l1 = t.l1;
+    const int yy = std::stoi(l1.substr(18,2));
+    t.epoch_jd = jd_jan1(yy < 57 ? 2000+yy : 1900+yy) + parse_double(l1.substr(20,12)) - 1.0;
+    t.bstar = parse_tle_exp(l1.substr(53,8));
+
+    const std::string& l2 = t.l2;
+    t.inc_rad  = parse_double(l2.substr(8,8))  * DEG2RAD;
+    t.raan_rad = parse_double(l2.substr(17,8)) * DEG2RAD;
+    t.ecc      = parse_double("0."+l2.substr(26,7));
+    t.argp_rad = parse_double(l2.substr(34,8)) * DEG2RAD;
+    t.M_rad    = parse_double(l2.substr(43,8)) * DEG2RAD;
+    t.n_rev_per_day = parse_double(l2.substr(52,11));
+}
+
+bool read_next_tle(std::istream& f, TLE& t){
+    std::string name,l1,l2;
     while(true){
-        std::string name,l1,l2;
-        if(!std::getline(f,name)) break;
-        if(!std::getline(f,l1)) break;
-        if(!std::getline(f,l2)) break;
+        if(!std::getline(f,name)) return false;
+        if(!std::getline(f,l1)) return false;
+        if(!std::getline(f,l2)) return false;
 
         if(l1.size() < 69 || l2.size() < 69) continue;
 
-        TLE t;
-        t.name = name;
-        t.l1 = l1;
-        t.l2 = l2;
-
-        t.inc_rad  = parse_double(l2.substr(8,8))  * DEG2RAD;
-        t.raan_rad = parse_double(l2.substr(17,8)) * DEG2RAD;
-        t.ecc      = parse_double("0."+l2.substr(26,7));
-        t.argp_rad = parse_double(l2.substr(34,8)) * DEG2RAD;
-        t.M_rad    = parse_double(l2.substr(43,8)) * DEG2RAD;
-        t.n_rev_per_day = parse_double(l2.substr(52,11));
+        t = TLE{};
+        t.name = std::move(name);
+        t.l1 = std::move(l1);
+        t.l2 = std::move(l2);
+        parse_tle_elements(t);
+        return true;
+    }
+}
 
-        out.push_back(t);
+size_t count_tles_in_file(const std::string& path){
+    std::ifstream f(path);
+    if(!f) return 0;
+    size_t n = 0;
+    std::string name,l1,l2;
+    while(std::getline(f,name) && std::getline(f,l1) && std::getline(f,l2)){
+        if(l1.size() >= 69 && l2.size() >= 69) n++;
     }
+    return n;
+}
+
+bool load_tles_from_file(const std::string& path, std::vector<TLE>& out){
+    std::ifstream f(path);
+    if(!f) return false;
+
+    TLE t;
+    while(read_next_tle(f,t)) out.push_back(t);
     return true;
 }
 
@@ -0,0 +1,290 @@
+#include "model/access.hpp"
+#include "core/environment.hpp"
+#include "core/frames.hpp"
+#include "core/geodesy.hpp"
+#include "core/parallel.hpp"
+#include "core/tle.hpp"
+#include "core/tle_to_coe.hpp"
+#include "physics/secular.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
+static constexpr double DEG = M_PI/180.0;
+static constexpr double DAY_S = 86400.0;
+static constexpr double WGS84_B_KM = WGS84_A_KM*(1.0 - WGS84_F);
+static constexpr double SITE_MAX_ALT_KM = 100.0;    // Environment entries treated as ground sites
+static constexpr double CONE_MARGIN_RAD = 0.5*DEG;  // geodetic vs geocentric vertical (< 0.2 deg)
+static constexpr double REFINE_TOL_S = 0.01;
+static constexpr int REFINE_MAX_ITERS = 30;
+
+struct Site{
+    std::string name;
+    double x, y, z;     // ECEF km
+    double ux, uy, uz;  // geodetic up
+    double gx, gy, gz;  // geocentric unit vector
+};
+
+struct AccessWindow{
+    size_t site, sat;
+    double rise_s, set_s;
+    double max_sin_el;
+};
+
+// Sample times and the GMST rotation at each, shared by all satellites.
+struct AccessGrid{
+    double jd0 = 0.0;
+    double t_end = 0.0, step = 0.0;
+    std::vector<double> t, c, s;
+    double el_min = 0.0, sin_min = 0.0, cos_min = 1.0;
+    double cone_d = 0.0, cos_d = 1.0, sin_d = 0.0;   // el_min - CONE_MARGIN_RAD
+};
+
+static std::vector<Site> ground_sites(){
+    std::vector<Site> sites;
+    for(const auto& kv : Environment::instance().all()){
+        const Body& b = kv.second.body;
+        double lat, lon, alt;
+        ecef_to_geodetic(b.x, b.y, b.z, lat, lon, alt);
+        if(std::fabs(alt) > SITE_MAX_ALT_KM) continue;
+        const double r = std::sqrt(b.x*b.x + b.y*b.y + b.z*b.z);
+        const double cl = std::cos(lat*DEG), sl = std::sin(lat*DEG);
+        sites.push_back({kv.first, b.x, b.y, b.z,
+                         cl*std::cos(lon*DEG), cl*std::sin(lon*DEG), sl,
+                         b.x/r, b.y/r, b.z/r});
+    }
+    std::sort(sites.begin(), sites.end(), [](const Site& a, const Site& b){ return a.name < b.name; });
+    return sites;
+}
+
+static void ecef_at(const SecularCatalog& cat, size_t k, const AccessGrid& g, double t, double r[3]){
+    Body b;
+    cat.state_at(k, t, b);
+    const double ri[3] = {b.x, b.y, b.z};
+    eci_to_ecef(gmst_rad(g.jd0 + t/DAY_S), ri, nullptr, r, nullptr);
+}
+
+static double sin_elevation(const Site& s, const double r[3]){
+    const double dx = r[0] - s.x, dy = r[1] - s.y, dz = r[2] - s.z;
+    return (dx*s.ux + dy*s.uy + dz*s.uz)/std::sqrt(dx*dx + dy*dy + dz*dz);
+}
+
+static double elevation_margin(const SecularCatalog& cat, size_t k, const AccessGrid& g,
+                               const Site& s, double t){
+    double r[3];
+    ecef_at(cat, k, g, t, r);
+    return sin_elevation(s, r) - g.sin_min;
+}
+
+// sin(el) - sin(el_min) changes sign from fa to fb in (ta, tb]: Illinois false position, which
+// needs a handful of evaluations where bisection would need a dozen.
+static double refine_crossing(const SecularCatalog& cat, size_t k, const AccessGrid& g,
+                              const Site& s, double ta, double tb, double fa, double fb){
+    double t = tb;
+    int side = 0;
+    for(int it=0; it<REFINE_MAX_ITERS && fa != fb; it++){
+        const double tm = tb - fb*(tb - ta)/(fb - fa);
+        const bool done = std::fabs(tm - t) < REFINE_TOL_S;
+        t = tm;
+        if(done) break;
+        const double fm = elevation_margin(cat, k, g, s, tm);
+        if((fm >= 0.0) == (fb >= 0.0)){ tb = tm; fb = fm; if(side == -1) fa *= 0.5; side = -1; }
+        else{ ta = tm; fa = fm; if(side == +1) fb *= 0.5; side = +1; }
+    }
+    return t;
+}
+
+// Half-angle of the visibility cone (central angle from the site) for a
+// satellite at radius r; negative when it cannot clear el_min anywhere.
+static double cone_half_angle(const AccessGrid& g, double r){
+    return std::acos(std::min(1.0, WGS84_B_KM*g.cos_min/r)) - g.cone_d;
+}
+
+// cos of the same angle without the inverse trig; 2 (never inside) when
+// the half-angle is negative.
+static double cone_cos(const AccessGrid& g, double r){
+    const double q = std::min(1.0, WGS84_B_KM*g.cos_min/r);
+    if(g.cone_d >= 0.0 && q >= g.cos_d) return 2.0;
+    return q*g.cos_d + std::sqrt(1.0 - q*q)*g.sin_d;
+}
+
+// Returns the number of exact elevation evaluations.
+static size_t satellite_access(const SecularCatalog& cat, size_t k, const AccessGrid& g,
+                               const std::vector<Site>& sites, std::vector<AccessWindow>& out){
+    const size_t m = g.t.size();
+    thread_local std::vector<Body> states;
+    thread_local std::vector<double> px, py, pz, pr, cos_lim;
+    states.resize(m);
+    px.resize(m); py.resize(m); pz.resize(m); pr.resize(m); cos_lim.resize(m);
+
+    // ECEF unit vectors and cone limits at every sample.
+    cat.states_on_grid(k, 0.0, g.step, m, states.data());
+    for(size_t i=0;i<m;i++){
+        const Body& b = states[i];
+        const double x =  g.c[i]*b.x + g.s[i]*b.y;
+        const double y = -g.s[i]*b.x + g.c[i]*b.y;
+        const double r = std::sqrt(b.x*b.x + b.y*b.y + b.z*b.z);
+        px[i] = x/r; py[i] = y/r; pz[i] = b.z/r; pr[i] = r;
+        cos_lim[i] = cone_cos(g, r);
+    }
+
+    // Bound on how fast the sub-satellite point can close on a site: the
+    // perigee angular rate plus Earth rotation and the secular drifts.
+    const COE c = cat.elements_at(k, 0.0);
+    double raan_dot, argp_dot, M_dot;
+    j2_secular_rates(c.a, c.e, c.i, raan_dot, argp_dot, M_dot);
+    const double rate = std::fabs(M_dot)*std::sqrt((1.0 + c.e)/std::pow(1.0 - c.e, 3))
+                      + OMEGA_EARTH_RAD_S + std::fabs(raan_dot) + std::fabs(argp_dot);
+    const double lam_max = cone_half_angle(g, c.a*(1.0 + c.e));
+    if(lam_max <= 0.0) return 0;
+
+    auto margin_at = [&](const Site& s, size_t i){
+        const double r[3] = {px[i]*pr[i], py[i]*pr[i], pz[i]*pr[i]};
+        return sin_elevation(s, r) - g.sin_min;
+    };
+
+    size_t evals = 0;
+    for(size_t j=0;j<sites.size();j++){
+        const Site& s = sites[j];
+        bool in = false;
+        double rise = 0.0, max_s = 0.0;
+        size_t i = 0;
+        while(i < m){
+            const double ca = px[i]*s.gx + py[i]*s.gy + pz[i]*s.gz;
+            size_t next = i + 1;
+            bool vis = false;
+            double se = 0.0;
+            if(ca >= cos_lim[i]){
+                const double r[3] = {px[i]*pr[i], py[i]*pr[i], pz[i]*pr[i]};
+                se = sin_elevation(s, r);
+                vis = se >= g.sin_min;
+                evals++;
+            }else{
+                // Outside the cone: jump over samples the satellite cannot
+                // reach it by; the one landed on is tested again.
+                const double skip_s = (std::acos(std::max(-1.0, ca)) - lam_max)/rate;
+                if(skip_s > 2.0*g.step) next = std::min(m, i + (size_t)(skip_s/g.step));
+            }
+            if(vis != in){
+                const double t = i == 0 ? 0.0 : refine_crossing(cat, k, g, s, g.t[i-1], g.t[i],
+                                                                 margin_at(s, i-1), margin_at(s, i));
+                if(vis){ rise = t; max_s = se; }
+                else out.push_back({j, k, rise, t, max_s});
+                in = vis;
+            }
+            if(vis) max_s = std::max(max_s, se);
+            i = next;
+        }
+        if(in) out.push_back({j, k, rise, g.t_end, max_s});
+    }
+    return evals;
+}
+
+bool run_access(const std::string& tle_path, const AccessOptions& opt){
+    std::vector<TLE> tles;
+    if(!load_tles_from_file(tle_path, tles)){
+        std::cerr << "run_access: failed to read " << tle_path << "\n";
+        return false;
+    }
+    if(!(opt.step_s > 0.0) || !(opt.hours > 0.0)){
+        std::cerr << "run_access: step and span must be positive\n";
+        return false;
+    }
+    const std::vector<Site> sites = ground_sites();
+    if(sites.empty()){
+        std::cerr << "run_access: no ground sites registered\n";
+        return false;
+    }
+
+    AccessGrid g;
+    g.jd0 = opt.start_jd;
+    if(g.jd0 <= 0.0) for(const auto& t : tles) g.jd0 = std::max(g.jd0, t.epoch_jd);
+    // Uniform grid no coarser than step_s that ends exactly at t_end.
+    g.t_end = opt.hours*3600.0;
+    const size_t intervals = (size_t)std::ceil(g.t_end/opt.step_s - 1e-9);
+    g.step = g.t_end/intervals;
+    for(size_t i=0;i<=intervals;i++) g.t.push_back(i*g.step);
+    for(double t : g.t){
+        const double gm = gmst_rad(g.jd0 + t/DAY_S);
+        g.c.push_back(std::cos(gm));
+        g.s.push_back(std::sin(gm));
+    }
+    g.el_min = opt.min_elevation_deg*DEG;
+    g.sin_min = std::sin(g.el_min);
+    g.cos_min = std::cos(g.el_min);
+    g.cone_d = g.el_min - CONE_MARGIN_RAD;
+    g.cos_d = std::cos(g.cone_d);
+    g.sin_d = std::sin(g.cone_d);
+
+    // TLE mean elements taken as secular-J2 mean elements at each epoch.
+    SecularCatalog cat;
+    std::vector<size_t> tle_of;
+    cat.reserve(tles.size());
+    for(size_t i=0;i<tles.size();i++){
+        COE c{};
+        tle_to_coe(tles[i], MU_E_KM3_S2, c);
+        if(!(c.a > 0.0) || !(c.e < 1.0)) continue;
+        c.ta = true_from_mean(tles[i].M_rad, c.e);
+        cat.add(c, 0.0, (tles[i].epoch_jd - g.jd0)*DAY_S);
+        tle_of.push_back(i);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::vector<AccessWindow>> per_sat(cat.size());
+    std::vector<size_t> evals(cat.size());
+    work_stealing_for(cat.size(), opt.threads, [&](size_t k){
+        evals[k] = satellite_access(cat, k, g, sites, per_sat[k]);
+    });
+
+    std::vector<AccessWindow> windows;
+    size_t total_evals = 0;
+    for(size_t k=0;k<cat.size();k++){
+        windows.insert(windows.end(), per_sat[k].begin(), per_sat[k].end());
+        total_evals += evals[k];
+    }
+    std::sort(windows.begin(), windows.end(), [](const AccessWindow& a, const AccessWindow& b){
+        if(a.site != b.site) return a.site < b.site;
+        if(a.rise_s != b.rise_s) return a.rise_s < b.rise_s;
+        return a.sat < b.sat;
+    });
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ofstream file;
+    if(!opt.output.empty()){
+        file.open(opt.output);
+        if(!file){
+            std::cerr << "run_access: cannot write " << opt.output << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    out << "site,satellite,rise_jd,rise_utc,set_jd,set_utc,duration_s,max_el_deg\n";
+    char num[200];
+    for(const auto& w : windows){
+        std::string name = tles[tle_of[w.sat]].name;
+        while(!name.empty() && name.back()==' ') name.pop_back();
+        const double rise_jd = g.jd0 + w.rise_s/DAY_S, set_jd = g.jd0 + w.set_s/DAY_S;
+        std::snprintf(num, sizeof(num), "%.6f,%s,%.6f,%s,%.1f,%.2f",
+                      rise_jd, jd_to_utc(rise_jd, true).c_str(), set_jd, jd_to_utc(set_jd, true).c_str(),
+                      w.set_s - w.rise_s, std::asin(std::min(1.0, w.max_sin_el))/DEG);
+        out << sites[w.site].name << "," << name << "," << num << "\n";
+    }
+
+    if(!opt.output.empty()){
+        const double brute = (double)cat.size()*sites.size()*g.t.size();
+        std::cout << "access sites " << sites.size()
+                  << " satellites " << cat.size()
+                  << " windows " << windows.size()
+                  << " elevation_tests " << total_evals
+                  << " of " << brute
+                  << " elapsed_s " << elapsed << "\n";
+        std::cout << "access table written: " << opt.output << "\n";
+    }
+    return (bool)out;
+}
@@ -0,0 +1,225 @@
+#include "model/bench.hpp"
+#include "physics/engine.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/force_model.hpp"
+#include "orbit/lambert.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418;
+static constexpr double BENCH_DT_S = 10.0;
+
+// Circular orbits spread over altitude, inclination and node so no two
+// bodies share a trajectory.
+static void seed_shell(PhysicsEngine& e, size_t n){
+    e.bodies.clear();
+    e.names.clear();
+    e.bodies.reserve(n);
+    for(size_t i=0;i<n;i++){
+        const double a = 6778.0 + (double)(i % 1000);
+        const double inc = 0.1 + 1.5 * (double)(i % 97) / 97.0;
+        const double raan = 2.0 * M_PI * (double)(i % 389) / 389.0;
+        const double v = std::sqrt(MU_E_KM3_S2 / a);
+        Body b;
+        b.x = a*std::cos(raan);
+        b.y = a*std::sin(raan);
+        b.vx = -v*std::sin(raan)*std::cos(inc);
+        b.vy =  v*std::cos(raan)*std::cos(inc);
+        b.vz =  v*std::sin(inc);
+        b.mass = 100.0;
+        e.bodies.push_back(b);
+    }
+    e.names.assign(n, std::string());
+    e.surfaces.assign(n, BodySurface{1.0, 2.2, 1.3});
+}
+
+bool run_force_bench(size_t bodies, int steps){
+    if(bodies == 0 || steps <= 0){
+        std::cerr << "run_force_bench: bodies and steps must be positive\n";
+        return false;
+    }
+
+    auto eph = std::make_shared<Ephemeris>();
+    eph->fit_analytic(2451545.0, steps * BENCH_DT_S + 86400.0);
+
+    for(const auto& m : force_models()){
+        PhysicsEngine e;
+        e.ephemeris = eph;
+        seed_shell(e, bodies);
+        if(m.features & FORCE_J2) e.set_gravity(2, 0);
+        if(m.features & FORCE_HARMONICS) e.set_gravity(6, 6);
+        if(m.features & FORCE_THIRD_BODY) e.enable_third_body({"Sun","Moon"});
+        if(m.features & FORCE_DRAG) e.set_drag(true);
+        if(m.features & FORCE_SRP) e.set_srp(true);
+        if(!e.use_force_model(&m)){
+            std::cerr << "run_force_bench: cannot configure " << m.name << "\n";
+            return false;
+        }
+
+        e.step(BENCH_DT_S); // warm caches and scratch
+        const auto t0 = std::chrono::steady_clock::now();
+        for(int k=0;k<steps;k++) e.step(BENCH_DT_S);
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        std::cout << "force_model " << m.name
+                  << " bodies " << bodies
+                  << " steps " << steps
+                  << " ns_per_body_step " << ns / ((double)steps * (double)bodies)
+                  << "\n";
+    }
+    return true;
+}
+
+struct LambertCase{
+    std::array<double,3> r1, r2;
+    double tof;
+};
+
+// Deterministic uniform [0,1) stream, so runs are comparable.
+static constexpr double BENCH_MISS_TOL_KM = 1.0;
+static constexpr double BENCH_DV_TOL_KM_S = 1e-3;
+
+static double bench_uniform(uint64_t& state){
+    state = state*6364136223846793005ULL + 1442695040888963407ULL;
+    return (double)(state >> 11) * (1.0/9007199254740992.0);
+}
+
+// LEO..GEO radii, 10..170 deg prograde transfer angles in planes tilted up
+// to 60 deg, TOF from a third to twice the mean circular period.
+static std::vector<LambertCase> seed_lambert_cases(size_t n){
+    std::vector<LambertCase> cases(n);
+    uint64_t st = 42;
+    for(auto& c : cases){
+        const double ra = 6678.0 + 35500.0*bench_uniform(st);
+        const double rb = 6678.0 + 35500.0*bench_uniform(st);
+        const double th0 = 2.0*M_PI*bench_uniform(st);
+        const double dth = (10.0 + 160.0*bench_uniform(st))*M_PI/180.0;
+        const double inc = (60.0*bench_uniform(st))*M_PI/180.0;
+        const double raan = 2.0*M_PI*bench_uniform(st);
+        auto place = [&](double r, double th){
+            const double x = r*std::cos(th), y = r*std::sin(th)*std::cos(inc), z = r*std::sin(th)*std::sin(inc);
+            return std::array<double,3>{x*std::cos(raan) - y*std::sin(raan), x*std::sin(raan) + y*std::cos(raan), z};
+        };
+        c.r1 = place(ra, th0);
+        c.r2 = place(rb, th0 + dth);
+        const double am = 0.5*(ra + rb);
+        const double period = 2.0*M_PI*std::sqrt(am*am*am/MU_E_KM3_S2);
+        c.tof = period*(1.0/3.0 + (5.0/3.0)*bench_uniform(st));
+    }
+    return cases;
+}
+
+// Two-body position miss (km) of r1, v1 flown for tof against r2, by
+// Lagrange f and g in the eccentric-anomaly change;
+// negative when the transfer is not an ellipse.
+static double lambert_miss_km(const LambertCase& c, const LambertSolution& s){
+    const auto& r = c.r1;
+    const auto& v = s.v1_km_s;
+    const double r0 = std::sqrt(r[0]*r[0] + r[1]*r[1] + r[2]*r[2]);
+    const double v2 = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+    const double a = 1.0/(2.0/r0 - v2/MU_E_KM3_S2);
+    if(!(a > 0.0)) return -1.0;
+    // e cos E0 and e sin E0 from the initial state, then Kepler's equation
+    // for E1 with M reduced to [-pi, pi] and the whole revolutions put back.
+    const double ec = 1.0 - r0/a;
+    const double es = (r[0]*v[0] + r[1]*v[1] + r[2]*v[2])/std::sqrt(MU_E_KM3_S2*a);
+    const double e = std::sqrt(ec*ec + es*es);
+    const double E0 = std::atan2(es, ec);
+    const double M1 = E0 - es + std::sqrt(MU_E_KM3_S2/(a*a*a))*c.tof;
+    const double Mr = std::remainder(M1, 2.0*M_PI);
+    double E1 = e < 0.8 ? Mr : (Mr < 0.0 ? -M_PI : M_PI);
+    for(int it=0; it<60; it++){
+        const double d = (E1 - e*std::sin(E1) - Mr)/(1.0 - e*std::cos(E1));
+        E1 -= d;
+        if(std::fabs(d) < 1e-14) break;
+    }
+    const double dE = E1 + (M1 - Mr) - E0;
+    const double f = 1.0 - a/r0*(1.0 - std::cos(dE));
+    const double g = c.tof + std::sqrt(a*a*a/MU_E_KM3_S2)*(std::sin(dE) - dE);
+    double miss2 = 0.0;
+    for(int k=0;k<3;k++){
+        const double d = f*r[k] + g*v[k] - c.r2[k];
+        miss2 += d*d;
+    }
+    return std::sqrt(miss2);
+}
+
+bool run_lambert_bench(size_t cases){
+    if(cases == 0){
+        std::cerr << "run_lambert_bench: cases must be positive\n";
+        return false;
+    }
+    const std::vector<LambertCase> cs = seed_lambert_cases(cases);
+    std::vector<std::vector<LambertSolution>> sols[2];
+
+    const struct { LambertMethod m; const char* name; } methods[] = {
+        {LAMBERT_UNIVERSAL, "uv"}, {LAMBERT_IZZO, "izzo"}};
+    for(int k=0;k<2;k++){
+        sols[k].resize(cs.size());
+        const auto t0 = std::chrono::steady_clock::now();
+        for(size_t i=0;i<cs.size();i++)
+            sols[k][i] = lambert_intercept(cs[i].r1, cs[i].r2, cs[i].tof, MU_E_KM3_S2, 0, methods[k].m);
+        const double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - t0).count();
+
+        double worst = 0.0;
+        size_t hit = 0, good = 0;
+        for(size_t i=0;i<cs.size();i++){
+            if(sols[k][i].empty()) continue;
+            const double miss = lambert_miss_km(cs[i], sols[k][i][0]);
+            if(miss < 0.0) continue;
+            worst = std::max(worst, miss);
+            hit++;
+            good += miss < BENCH_MISS_TOL_KM;
+        }
+        std::cout << "lambert " << methods[k].name
+                  << " cases " << cs.size()
+                  << " ns_per_solve " << ns / (double)cs.size()
+                  << " checked " << hit
+                  << " within_1km " << good
+                  << " max_miss_km " << worst << "\n";
+    }
+
+    // Single-revolution departure velocities, where both returned one.
+    size_t both = 0, agree = 0;
+    for(size_t i=0;i<cs.size();i++){
+        if(sols[0][i].empty() || sols[1][i].empty()) continue;
+        double d = 0.0;
+        for(int j=0;j<3;j++)
+            d = std::max(d, std::fabs(sols[0][i][0].v1_km_s[j] - sols[1][i][0].v1_km_s[j]));
+        both++;
+        agree += d < BENCH_DV_TOL_KM_S;
+    }
+    std::cout << "lambert agreement dv1_within_1m_s " << agree << " of " << both << "\n";
+
+    // Multi-revolution branches: every returned solution should hit r2.
+    static constexpr int BENCH_MAX_REV = 3;
+    for(int k=0;k<2;k++){
+        size_t n_sol = 0, hit = 0, good = 0;
+        double worst = 0.0;
+        for(const auto& c : cs){
+            const auto v = lambert_intercept(c.r1, c.r2, c.tof, MU_E_KM3_S2, BENCH_MAX_REV, methods[k].m);
+            for(const auto& s : v){
+                n_sol++;
+                const double miss = lambert_miss_km(c, s);
+                if(miss < 0.0) continue;
+                worst = std::max(worst, miss);
+                hit++;
+                good += miss < BENCH_MISS_TOL_KM;
+            }
+        }
+        std::cout << "lambert " << methods[k].name
+                  << " max_rev " << BENCH_MAX_REV
+                  << " solutions " << n_sol
+                  << " checked " << hit
+                  << " within_1km " << good
+                  << " max_miss_km " << worst << "\n";
+    }
+    return true;
+}
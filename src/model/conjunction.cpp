@@ -0,0 +1,112 @@
+#include "model/conjunction.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <vector>
+
+static constexpr size_t EVENT_FIELDS = 23;
+static constexpr size_t EVENT_NUMBERS = EVENT_FIELDS - 3;
+
+struct EventLabel{
+    std::string id1, id2, tca;
+};
+
+static const char* method_name(PcMethod m){
+    return m == PC_SERIES ? "series" : m == PC_INTEGRATE ? "integrate" : "auto";
+}
+
+static bool parse_event(const std::string& line, EventLabel& label, ConjunctionEvent& ev){
+    std::vector<std::string> f;
+    std::stringstream ss(line);
+    std::string cell;
+    while(std::getline(ss, cell, ',')) f.push_back(cell);
+    if(f.size() != EVENT_FIELDS) return false;
+    double num[EVENT_NUMBERS];
+    for(size_t k=0;k<EVENT_NUMBERS;k++){
+        const char* s = f[3 + k].c_str();
+        char* end = nullptr;
+        num[k] = std::strtod(s, &end);
+        if(end == s) return false;
+    }
+    label = {f[0], f[1], f[2]};
+    std::copy(num, num + 3, ev.r);
+    std::copy(num + 3, num + 6, ev.v);
+    std::copy(num + 6, num + 12, ev.c1);
+    std::copy(num + 12, num + 18, ev.c2);
+    ev.hbr_km = 1e-3*(num[18] + num[19]);
+    return true;
+}
+
+bool run_pc(const std::string& events_path, const PcOptions& opt){
+    std::ifstream in(events_path);
+    if(!in){
+        std::cerr << "run_pc: failed to read " << events_path << "\n";
+        return false;
+    }
+    std::vector<EventLabel> labels;
+    std::vector<ConjunctionEvent> events;
+    std::string line;
+    size_t line_no = 0;
+    while(std::getline(in, line)){
+        line_no++;
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        if(line.empty() || line[0] == '#' || line.compare(0, 3, "id1") == 0) continue;
+        EventLabel label;
+        ConjunctionEvent ev;
+        if(!parse_event(line, label, ev)){
+            std::cerr << "run_pc: " << events_path << ":" << line_no
+                      << ": expected " << EVENT_FIELDS << " comma-separated fields\n";
+            return false;
+        }
+        labels.push_back(std::move(label));
+        events.push_back(ev);
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<PcResult> res(events.size());
+    collision_probability_batch(events.size(), events.data(), res.data(), opt.method, opt.threads);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::vector<size_t> order(events.size());
+    std::iota(order.begin(), order.end(), (size_t)0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return res[a].pc > res[b].pc; });
+
+    std::ofstream file;
+    if(!opt.output.empty()){
+        file.open(opt.output);
+        if(!file){
+            std::cerr << "run_pc: cannot write " << opt.output << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    out << "id1,id2,tca_utc,miss_km,sigma_major_km,sigma_minor_km,hbr_m,pc,method\n";
+    char num[160];
+    size_t series = 0, failed = 0;
+    for(size_t i : order){
+        const PcResult& r = res[i];
+        if(!r.ok){ failed++; continue; }
+        if(r.method == PC_SERIES) series++;
+        std::snprintf(num, sizeof(num), "%.6f,%.6f,%.6f,%.2f,%.6e,%s",
+                      r.miss_km, r.sigma_major_km, r.sigma_minor_km, events[i].hbr_km*1000.0, r.pc,
+                      method_name(r.method));
+        out << labels[i].id1 << "," << labels[i].id2 << "," << labels[i].tca << "," << num << "\n";
+    }
+    if(failed) std::cerr << "run_pc: " << failed << " events skipped (zero relative velocity or singular covariance)\n";
+
+    if(!opt.output.empty()){
+        std::cout << "pc events " << events.size()
+                  << " series " << series
+                  << " integrate " << events.size() - series - failed
+                  << " skipped " << failed
+                  << " elapsed_s " << elapsed << "\n";
+        std::cout << "pc table written: " << opt.output << "\n";
+    }
+    return (bool)out;
+}
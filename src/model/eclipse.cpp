@@ -0,0 +1,163 @@
+#include "model/eclipse.hpp"
+#include "core/geodesy.hpp"
+#include "physics/secular.hpp"
+#include "physics/shadow.hpp"
+#include "physics/sun.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+static constexpr double DAY_S = 86400.0;
+static constexpr double REFINE_TOL_S = 1e-3;
+
+enum class ShadowKind{ Penumbra, Umbra };
+
+struct EclipseInterval{
+    size_t body;
+    ShadowKind kind;
+    double start_s, end_s;
+};
+
+// Cubic Hermite position between two step endpoints, tau in [0,1].
+static void hermite_position(const Body& a, const Body& b, double h, double tau, double r[3]){
+    const double t2 = tau*tau, t3 = t2*tau;
+    const double h00 = 2*t3 - 3*t2 + 1, h10 = (t3 - 2*t2 + tau)*h;
+    const double h01 = -2*t3 + 3*t2,    h11 = (t3 - t2)*h;
+    r[0] = h00*a.x + h10*a.vx + h01*b.x + h11*b.vx;
+    r[1] = h00*a.y + h10*a.vy + h01*b.y + h11*b.vy;
+    r[2] = h00*a.z + h10*a.vz + h01*b.z + h11*b.vz;
+}
+
+static double boundary_margin(const Body& a, const Body& b, double h, double tau,
+                              const double s0[3], const double s1[3], ShadowKind kind){
+    double r[3];
+    hermite_position(a, b, h, tau, r);
+    const double sun[3] = { s0[0] + tau*(s1[0] - s0[0]),
+                            s0[1] + tau*(s1[1] - s0[1]),
+                            s0[2] + tau*(s1[2] - s0[2]) };
+    double pen, umb;
+    shadow_margins(r[0], r[1], r[2], sun, pen, umb);
+    return kind == ShadowKind::Umbra ? umb : pen;
+}
+
+// The kind's boundary is crossed once in the step [t, t+h]: bisect on the
+// Hermite arc to REFINE_TOL_S. Returns the crossing time.
+static double refine_crossing(const Body& a, const Body& b, double t, double h,
+                              const double s0[3], const double s1[3], ShadowKind kind){
+    double lo = 0.0, hi = 1.0;
+    const bool inside_lo = boundary_margin(a, b, h, lo, s0, s1, kind) > 0.0;
+    while((hi - lo)*h > REFINE_TOL_S){
+        const double mid = 0.5*(lo + hi);
+        if((boundary_margin(a, b, h, mid, s0, s1, kind) > 0.0) == inside_lo) lo = mid; else hi = mid;
+    }
+    return t + 0.5*(lo + hi)*h;
+}
+
+static void sun_at(double jd, double s[3]){
+    const auto v = sun_eci_km(jd);
+    s[0] = v[0]; s[1] = v[1]; s[2] = v[2];
+}
+
+bool run_eclipses(PhysicsEngine& e, const ScenarioCfg& cfg, const std::string& output){
+    const size_t n = e.bodies.size();
+    if(n == 0){
+        std::cerr << "run_eclipses: scenario has no bodies\n";
+        return false;
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool secular = cfg.propagator == PROPAGATOR_SECULAR_J2;
+    SecularCatalog cat;
+    if(secular){
+        cat.reserve(n);
+        for(const auto& b : e.bodies) cat.add(b);
+    }
+
+    std::vector<Body> prev(n);
+    std::vector<unsigned char> st0(n), st1(n);
+    std::vector<double> pen_start(n, 0.0), umb_start(n, 0.0);
+    std::vector<EclipseInterval> intervals;
+    size_t exact = 0, classified = 0;
+
+    double s0[3], s1[3];
+    sun_at(cfg.epoch_jd, s0);
+    exact += shadow_batch(n, &e.bodies[0].x, sizeof(Body)/sizeof(double), s0, st0.data());
+    classified += n;
+
+    double t = 0.0;
+    while(t < cfg.t_end){
+        const double h = cfg.dt;
+        prev = e.bodies;
+        if(secular){
+            cat.states_at(t + h, e.bodies.data());
+            e.time = t + h;
+        }else{
+            e.step(h);
+        }
+        sun_at(cfg.epoch_jd + (t + h)/DAY_S, s1);
+        exact += shadow_batch(n, &e.bodies[0].x, sizeof(Body)/sizeof(double), s1, st1.data());
+        classified += n;
+
+        for(size_t i=0;i<n;i++){
+            if(st0[i] == st1[i]) continue;
+            const bool pen0 = st0[i] != SHADOW_NONE, pen1 = st1[i] != SHADOW_NONE;
+            const bool umb0 = st0[i] == SHADOW_UMBRA, umb1 = st1[i] == SHADOW_UMBRA;
+            if(pen0 != pen1){
+                const double tc = refine_crossing(prev[i], e.bodies[i], t, h, s0, s1, ShadowKind::Penumbra);
+                if(pen1) pen_start[i] = tc;
+                else intervals.push_back({i, ShadowKind::Penumbra, pen_start[i], tc});
+            }
+            if(umb0 != umb1){
+                const double tc = refine_crossing(prev[i], e.bodies[i], t, h, s0, s1, ShadowKind::Umbra);
+                if(umb1) umb_start[i] = tc;
+                else intervals.push_back({i, ShadowKind::Umbra, umb_start[i], tc});
+            }
+        }
+        std::swap(st0, st1);
+        std::copy(s1, s1 + 3, s0);
+        t += h;
+    }
+    for(size_t i=0;i<n;i++){
+        if(st0[i] != SHADOW_NONE) intervals.push_back({i, ShadowKind::Penumbra, pen_start[i], t});
+        if(st0[i] == SHADOW_UMBRA) intervals.push_back({i, ShadowKind::Umbra, umb_start[i], t});
+    }
+    std::sort(intervals.begin(), intervals.end(), [](const EclipseInterval& a, const EclipseInterval& b){
+        if(a.body != b.body) return a.body < b.body;
+        if(a.start_s != b.start_s) return a.start_s < b.start_s;
+        return a.kind < b.kind;
+    });
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ofstream file;
+    if(!output.empty()){
+        file.open(output);
+        if(!file){
+            std::cerr << "run_eclipses: cannot write " << output << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    out << "entity,kind,start_jd,start_utc,end_jd,end_utc,duration_s\n";
+    char num[200];
+    for(const auto& iv : intervals){
+        const double a = cfg.epoch_jd + iv.start_s/DAY_S, b = cfg.epoch_jd + iv.end_s/DAY_S;
+        std::snprintf(num, sizeof(num), "%.8f,%s,%.8f,%s,%.3f",
+                      a, jd_to_utc(a, true).c_str(), b, jd_to_utc(b, true).c_str(), iv.end_s - iv.start_s);
+        const char* name = iv.body < e.names.size() ? e.names[iv.body].c_str() : "";
+        out << name << "," << (iv.kind == ShadowKind::Umbra ? "umbra" : "penumbra") << "," << num << "\n";
+    }
+
+    if(!output.empty()){
+        std::cout << "eclipses bodies " << n
+                  << " intervals " << intervals.size()
+                  << " exact_tests " << exact
+                  << " of " << classified
+                  << " elapsed_s " << elapsed << "\n";
+        std::cout << "eclipse table written: " << output << "\n";
+    }
+    return (bool)out;
+}
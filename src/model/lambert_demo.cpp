@@ -1,12 +1,22 @@
 #include "model/lambert_demo.hpp"
 #include "orbit/lambert.hpp"
+#include "orbit/relative.hpp"
+#include "physics/stm.hpp"
 #include <array>
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <vector>
 #include <algorithm>
 
 static constexpr double MU_E_KM3_S2 = 398600.4418;
+static constexpr int NMC_SAMPLES_PER_ORBIT = 96;
+// CW error allowed per design, as a fraction of its size b: the sweep
+// compares closest approaches across sizes, not metre-level positions.
+static constexpr double NMC_CW_REL_TOL = 0.05;
+static constexpr double SHOOT_TOL_KM = 1e-3;
+static constexpr double SIGMA0_POS_KM = 0.1;      // departure 1-sigma
+static constexpr double SIGMA0_VEL_KM_S = 1e-4;
 
 static inline std::array<double,3> r_of(const Body& b){ return {b.x,b.y,b.z}; }
 static inline std::array<double,3> v_of(const Body& b){ return {b.vx,b.vy,b.vz}; }
@@ -71,25 +81,6 @@ static Body propagate_to_tof(const Body& b0, double tof_s){
     return b;
 }
 
-static LambertSolution pick_min_dv1(const std::vector<LambertSolution>& sols,
-                                   const std::array<double,3>& v_now_km_s)
-{
-    if(sols.empty()){
-        return LambertSolution{{NAN,NAN,NAN},{NAN,NAN,NAN}};
-    }
-    double best = std::numeric_limits<double>::infinity();
-    size_t best_i = 0;
-    for(size_t i=0;i<sols.size();++i){
-        auto dv = sub3(sols[i].v1_km_s, v_now_km_s);
-        double m = norm3(dv);
-        if(std::isfinite(m) && m < best){
-            best = m;
-            best_i = i;
-        }
-    }
-    return sols[best_i];
-}
-
 static void run_case_intercept(Body ace0, Body chat0, PhysicsEngine& e){
     const double tof_s = 12.0*3600.0;     // 12 hours
     const int    max_rev = 3;
@@ -166,6 +157,102 @@ static void run_case_nmc(Body ace0, Body chat0){
     dv_to_ric_m_s(dv, r_of(ace0), v_of(ace0));
 }
 
+// NMC designs over size and entry angle: each is one Lambert solve to its
+// insertion point, then all designs are flown together for an orbit in the
+// target frame (one CW transition per sample time and size, with Kepler
+// fallback past NMC_CW_REL_TOL) for their closest approach.
+static void run_case_nmc_sweep(Body ace0, Body chat0){
+    const double tof_s = 12.0*3600.0;
+    Body chat_f = propagate_to_tof(chat0, tof_s);
+    const RicFrame f = ric_frame(r_of(chat_f), v_of(chat_f), MU_E_KM3_S2);
+
+    const double sizes_km[] = {1.0, 2.0, 5.0, 10.0, 20.0};
+    const size_t per_size = 12;
+    std::vector<double> b_km, theta_deg, dv_m_s, rel;
+    for(double b : sizes_km){
+        for(size_t j=0; j<per_size; j++){
+            const int th = (int)j*30;
+            double s[6];
+            cw_nmc_state(b, th*M_PI/180.0, f.n, s);
+            std::array<double,3> r2, v2;
+            ric_to_eci(f, s, r2, v2);
+            auto sols = lambert_intercept(r_of(ace0), r2, tof_s, MU_E_KM3_S2, 0, LAMBERT_IZZO);
+            double dv1 = NAN, dv2 = NAN;
+            pick_min_dv_total(sols, v_of(ace0), v2, dv1, dv2);
+            b_km.push_back(b);
+            theta_deg.push_back(th);
+            dv_m_s.push_back((dv1 + dv2)*1000.0);
+            rel.insert(rel.end(), s, s + 6);
+        }
+    }
+
+    const size_t m = b_km.size();
+    const double period = 2.0*M_PI/f.n;
+    std::vector<double> min_range(m, std::numeric_limits<double>::infinity()), out(6*m);
+    size_t fallbacks = 0;
+    for(int k=1; k<=NMC_SAMPLES_PER_ORBIT; k++){
+        for(size_t g=0; g<m; g+=per_size)
+            fallbacks += relative_propagate(f, period*k/NMC_SAMPLES_PER_ORBIT, per_size, rel.data() + 6*g,
+                                            out.data() + 6*g, NMC_CW_REL_TOL*b_km[g], MU_E_KM3_S2);
+        for(size_t i=0;i<m;i++){
+            const double* o = out.data() + 6*i;
+            min_range[i] = std::min(min_range[i], std::sqrt(o[0]*o[0] + o[1]*o[1] + o[2]*o[2]));
+        }
+    }
+
+    std::cout << "=== NMC SWEEP (TOF 43200s, CW over one orbit) ===\n";
+    std::cout << "designs " << m << " samples " << NMC_SAMPLES_PER_ORBIT << " cw_fallbacks " << fallbacks << "\n";
+    std::cout << "b_km theta_deg DV_total_m_s min_range_km\n";
+    for(size_t i=0;i<m;i++)
+        std::cout << b_km[i] << " " << theta_deg[i] << " " << dv_m_s[i] << " " << min_range[i] << "\n";
+}
+
+// The Lambert intercept is two-body exact but the chaser is flown on the
+// integrator, so it misses; shooting with the STM of that same integrator
+// removes the miss, and the STM maps a departure covariance to arrival.
+static void run_case_shooting(Body ace0, Body chat0){
+    const double tof_s = 12.0*3600.0;
+    const double dt = 10.0;
+    Body chat_f = propagate_to_tof(chat0, tof_s);
+
+    auto sols = lambert_intercept(r_of(ace0), r_of(chat_f), tof_s, MU_E_KM3_S2, 3);
+    auto best = pick_min_dv1(sols, v_of(ace0));
+    Body ace = ace0;
+    ace.vx = best.v1_km_s[0]; ace.vy = best.v1_km_s[1]; ace.vz = best.v1_km_s[2];
+    const double miss0 = norm3(sub3(r_of(propagate_to_tof(ace, tof_s)), r_of(chat_f)));
+
+    Body shot = ace;
+    const int corrections = target_position(shot, r_of(chat_f), tof_s, dt, 0.0, SHOOT_TOL_KM);
+
+    StmPropagator p;
+    p.reset(&shot, 1);
+    p.propagate(tof_s, dt);
+    const Body arrive = p.state(0);
+    double phi[6][6], p0[6][6] = {}, pf[6][6];
+    p.stm(0, phi);
+    for(int k=0;k<3;k++){
+        p0[k][k] = SIGMA0_POS_KM*SIGMA0_POS_KM;
+        p0[k+3][k+3] = SIGMA0_VEL_KM_S*SIGMA0_VEL_KM_S;
+    }
+    propagate_covariance(phi, p0, pf);
+    const RicFrame f = ric_frame(r_of(arrive), v_of(arrive), MU_E_KM3_S2);
+    double sigma[3];
+    const std::array<double,3>* axes[3] = {&f.eR, &f.eI, &f.eC};
+    for(int a=0;a<3;a++){
+        const auto& u = *axes[a];
+        double s2 = 0.0;
+        for(int r=0;r<3;r++) for(int c=0;c<3;c++) s2 += u[r]*pf[r][c]*u[c];
+        sigma[a] = std::sqrt(s2);
+    }
+
+    std::cout << "=== INTERCEPT SHOOTING (STM, TOF 43200s) ===\n";
+    std::cout << "lambert_miss_km " << miss0 << "\n";
+    std::cout << "corrections " << corrections
+              << " miss_km " << norm3(sub3(r_of(arrive), r_of(chat_f)))
+              << " DV_correction_m_s " << norm3(sub3(v_of(shot), v_of(ace)))*1000.0 << "\n";
+    std::cout << "arrival_sigma_RIC_km " << sigma[0] << " " << sigma[1] << " " << sigma[2] << "\n";
+}
+
 void run_lambert_demo(PhysicsEngine& e)
 {
     if(e.bodies.size() < 2){
@@ -179,4 +266,6 @@ void run_lambert_demo(PhysicsEngine& e)
     run_case_intercept(ace0, chat0, e);
     run_case_rendezvous(ace0, chat0);
     run_case_nmc(ace0, chat0);
+    run_case_nmc_sweep(ace0, chat0);
+    run_case_shooting(ace0, chat0);
 }
@@ -0,0 +1,242 @@
+#include "model/lifetime.hpp"
+#include "core/geodesy.hpp"
+#include "core/parallel.hpp"
+#include "core/tle.hpp"
+#include "physics/atmosphere.hpp"
+#include "physics/engine.hpp"
+#include "physics/orbit.hpp"
+#include "physics/secular.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
+static constexpr double R_E_KM = 6378.137;
+static constexpr double OMEGA_E_RAD_S = 7.2921159e-5;
+static constexpr double TWO_PI = 2.0*M_PI;
+static constexpr double DAY_S = 86400.0;
+
+static constexpr double DECAY_ALT_KM = 100.0;
+static constexpr double SWITCH_DAYS = 3.0;         // numerical tail before decay
+static constexpr double NUMERIC_DT_S = 5.0;
+static constexpr double NUMERIC_MAX_DAYS = 10.0;   // then fall back to averaging
+static constexpr double MAX_ORBITS_PER_STEP = 2000.0;
+static constexpr double STEP_PERIGEE_FRAC = 0.02;  // perigee change per step, of height above decay
+static constexpr int AVG_NODES = 1024;             // finest eccentric-anomaly grid
+
+struct MeanElements{ double a, e, i, raan, argp, M; };
+
+enum class DecayStatus{ Decayed, NoDecay, AboveAtmosphere, NoDrag };
+
+static const char* status_name(DecayStatus s){
+    switch(s){
+        case DecayStatus::Decayed:         return "decayed";
+        case DecayStatus::NoDecay:         return "no_decay";
+        case DecayStatus::AboveAtmosphere: return "above_atmosphere";
+        case DecayStatus::NoDrag:          return "no_drag";
+    }
+    return "?";
+}
+
+struct LifetimeResult{
+    DecayStatus status = DecayStatus::NoDecay;
+    double bc_m2_kg = 0.0;
+    double perigee_km = 0.0;
+    double apogee_km = 0.0;
+    double lifetime_s = 0.0;
+    long orbit_steps = 0;
+};
+
+struct AnomalyNodes{
+    double c[AVG_NODES];
+    AnomalyNodes(){ for(int k=0;k<AVG_NODES;k++) c[k] = std::cos(TWO_PI*k/AVG_NODES); }
+};
+
+static const AnomalyNodes& nodes(){
+    static const AnomalyNodes n;
+    return n;
+}
+
+// Orbit-averaged da/dt (km/s) and de/dt (1/s) for tangential drag. The mean
+// over mean anomaly is taken as a trapezoid sum in eccentric anomaly with
+// weight (1 - e cos E), which converges fast for this periodic integrand
+// once the perigee density peak (width ~ sqrt(2H/ae) in E) spans several
+// nodes, so eccentric orbits sample a finer grid.
+// Atmospheric co-rotation enters as King-Hele's (1 - r_p w cos i / v_p)^2.
+static void averaged_drag_rates(double a, double e, double inc, double bc, double& da, double& de){
+    const double ae = a*e;
+    const int stride = ae < 100.0 ? 16 : (ae < 2000.0 ? 4 : 1);
+    const int nn = AVG_NODES/stride;
+
+    double c[AVG_NODES], alt[AVG_NODES], rho[AVG_NODES];
+    for(int k=0;k<nn;k++){
+        c[k] = nodes().c[k*stride];
+        alt[k] = a*(1.0 - e*c[k]) - R_E_KM;
+    }
+    air_density_batch((size_t)nn, alt, rho);
+
+    const double mu_a = MU_E_KM3_S2/a;
+    double sa = 0.0, se = 0.0;
+    for(int k=0;k<nn;k++){
+        const double w = 1.0 - e*c[k];
+        const double v2 = mu_a*(1.0 + e*c[k])/w;
+        const double v = std::sqrt(v2);
+        const double cos_nu = (c[k] - e)/w;
+        sa += rho[k]*v2*v*w;
+        se += rho[k]*v*(e + cos_nu)*w;
+    }
+
+    const double rp = a*(1.0 - e);
+    const double vp = std::sqrt(mu_a*(1.0 + e)/(1.0 - e));
+    const double f = 1.0 - rp*OMEGA_E_RAD_S*std::cos(inc)/vp;
+    // rho [kg/m^3] * bc [m^2/kg] = 1/m = 1e3/km
+    const double k = bc*1000.0*f*f/nn;
+    da = -(a*a/MU_E_KM3_S2)*k*sa;
+    de = -k*se;
+}
+
+// Numerical J2 + drag from the current elements for up to NUMERIC_MAX_DAYS.
+// True (and t advanced to the decay time) if the body decays; otherwise m
+// is replaced by the osculating elements at the end of the window.
+static bool numeric_tail(MeanElements& m, double bc, double& t, double t_max){
+    PhysicsEngine e;
+    Body b = coe_to_body_eci({m.a, m.e, m.i, m.raan, m.argp, true_from_mean(m.M, m.e)});
+    b.mass = 1.0;
+    e.add(b, "");
+    e.surfaces.push_back({bc, 1.0});
+    e.set_gravity(2, 0);
+    e.set_drag(true);
+
+    const double r_decay = R_E_KM + DECAY_ALT_KM;
+    const double t_stop = std::min(t_max, t + NUMERIC_MAX_DAYS*DAY_S);
+    while(t < t_stop){
+        e.step(NUMERIC_DT_S);
+        t += NUMERIC_DT_S;
+        const Body& s = e.bodies[0];
+        if(s.x*s.x + s.y*s.y + s.z*s.z < r_decay*r_decay) return true;
+    }
+
+    const COE c = body_to_coe_eci(e.bodies[0]);
+    m = {c.a, c.e, c.i, c.raan, c.argp, mean_from_true(c.ta, c.e)};
+    return false;
+}
+
+static LifetimeResult predict_lifetime(const TLE& tle, const LifetimeOptions& opt){
+    LifetimeResult res;
+    const double n0 = tle.n_rev_per_day*TWO_PI/DAY_S;
+    MeanElements m{std::cbrt(MU_E_KM3_S2/(n0*n0)), tle.ecc, tle.inc_rad, tle.raan_rad, tle.argp_rad, tle.M_rad};
+
+    res.bc_m2_kg = tle.bstar > 0.0 ? bstar_to_bc_m2_kg(tle.bstar) : opt.default_bc_m2_kg;
+    res.perigee_km = m.a*(1.0 - m.e) - R_E_KM;
+    res.apogee_km  = m.a*(1.0 + m.e) - R_E_KM;
+    if(res.bc_m2_kg <= 0.0){ res.status = DecayStatus::NoDrag; return res; }
+    if(res.perigee_km >= ATMOSPHERE_TOP_KM){ res.status = DecayStatus::AboveAtmosphere; return res; }
+
+    const double horizon = opt.horizon_years*365.25*DAY_S;
+    const double bc = res.bc_m2_kg;
+    double t = 0.0;
+    while(t < horizon){
+        const double hp = m.a*(1.0 - m.e) - R_E_KM;
+        if(hp <= DECAY_ALT_KM){
+            res.status = DecayStatus::Decayed;
+            res.lifetime_s = t;
+            return res;
+        }
+
+        double da, de;
+        averaged_drag_rates(m.a, m.e, m.i, bc, da, de);
+        const double dhp = da*(1.0 - m.e) - m.a*de;
+
+        if(dhp < 0.0 && (hp - DECAY_ALT_KM)/(-dhp) < SWITCH_DAYS*DAY_S){
+            if(numeric_tail(m, bc, t, horizon)){
+                res.status = DecayStatus::Decayed;
+                res.lifetime_s = t;
+                return res;
+            }
+            continue;
+        }
+
+        // Whole orbits per step, sized so perigee moves a small fraction of
+        // its remaining height; midpoint rule on (a, e).
+        const double period = TWO_PI*std::sqrt(m.a*m.a*m.a/MU_E_KM3_S2);
+        double k = dhp < 0.0 ? std::floor(STEP_PERIGEE_FRAC*(hp - DECAY_ALT_KM)/(-dhp*period)) : MAX_ORBITS_PER_STEP;
+        k = std::clamp(k, 1.0, MAX_ORBITS_PER_STEP);
+        const double dt = std::min(k*period, horizon - t);
+
+        double da_mid, de_mid;
+        averaged_drag_rates(m.a + 0.5*dt*da, std::max(0.0, m.e + 0.5*dt*de), m.i, bc, da_mid, de_mid);
+
+        double raan_dot, argp_dot, M_dot;
+        j2_secular_rates(m.a, m.e, m.i, raan_dot, argp_dot, M_dot);
+        m.raan = std::fmod(m.raan + raan_dot*dt, TWO_PI);
+        m.argp = std::fmod(m.argp + argp_dot*dt, TWO_PI);
+        m.M    = std::fmod(m.M + M_dot*dt, TWO_PI);
+        m.a   += da_mid*dt;
+        m.e    = std::max(0.0, m.e + de_mid*dt);
+
+        t += dt;
+        res.orbit_steps++;
+    }
+    res.status = DecayStatus::NoDecay;
+    res.lifetime_s = horizon;
+    return res;
+}
+
+bool run_lifetime(const std::string& tle_path, const LifetimeOptions& opt){
+    std::vector<TLE> tles;
+    if(!load_tles_from_file(tle_path, tles)){
+        std::cerr << "run_lifetime: failed to read " << tle_path << "\n";
+        return false;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<LifetimeResult> res(tles.size());
+    work_stealing_for(tles.size(), opt.threads, [&](size_t i){
+        res[i] = predict_lifetime(tles[i], opt);
+    });
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ofstream file;
+    if(!opt.output.empty()){
+        file.open(opt.output);
+        if(!file){
+            std::cerr << "run_lifetime: cannot write " << opt.output << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    out << "name,epoch_jd,bc_m2_kg,perigee_km,apogee_km,status,decay_jd,decay_utc,lifetime_days\n";
+    size_t decayed = 0;
+    char num[160];
+    for(size_t i=0;i<tles.size();i++){
+        const TLE& t = tles[i];
+        const LifetimeResult& r = res[i];
+        std::string name = t.name;
+        while(!name.empty() && name.back()==' ') name.pop_back();
+        std::snprintf(num, sizeof(num), "%.6f,%.6g,%.1f,%.1f", t.epoch_jd, r.bc_m2_kg, r.perigee_km, r.apogee_km);
+        out << name << "," << num << "," << status_name(r.status) << ",";
+        if(r.status == DecayStatus::Decayed){
+            const double jd = t.epoch_jd + r.lifetime_s/DAY_S;
+            std::snprintf(num, sizeof(num), "%.4f,%s,%.2f", jd, jd_to_utc(jd).c_str(), r.lifetime_s/DAY_S);
+            out << num << "\n";
+            decayed++;
+        }else{
+            out << ",,\n";
+        }
+    }
+
+    if(!opt.output.empty()){
+        std::cout << "lifetime objects " << tles.size()
+                  << " decayed " << decayed
+                  << " horizon_years " << opt.horizon_years
+                  << " elapsed_s " << elapsed << "\n";
+        std::cout << "lifetime table written: " << opt.output << "\n";
+    }
+    return (bool)out;
+}
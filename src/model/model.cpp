@@ -2,20 +2,23 @@
 #include "core/environment.hpp"
 #include "core/vector.hpp"
 #include "physics/orbit.hpp"
+#include "physics/ephemeris.hpp"
 #include <iostream>
 #include <cmath>
 
 static std::array<double,3> pos(const Body& b){ return {b.x,b.y,b.z}; }
 
-void run_model(PhysicsEngine& e,double dt,double t_end,OutputWriter* ow){
+void run_model(PhysicsEngine& e,double dt,double t_end,OutputWriter* ow,
+               Checkpointer* cp,const Checkpoint* resume){
     auto& env=Environment::instance();
 
-    for(double t=0;t<=t_end;t+=dt){
+    for(double t=(resume ? resume->t : 0.0);t<=t_end;t+=dt){
         e.step(dt);
 
         if(ow && ow->enabled()) ow->tick(t,e);
 
         if(std::fmod(t,3600.0)==0.0){
+            if(e.ephemeris) refresh_environment(*e.ephemeris, t);
             auto sat=pos(e.bodies[0]);
             for(const auto& kv : env.all()){
                 const auto& name = kv.first;
@@ -26,6 +29,8 @@ void run_model(PhysicsEngine& e,double dt,double t_end,OutputWriter* ow){
                          <<" angle_deg "<<vec_angle_deg(sat,v)<<"\n";
             }
         }
+
+        if(cp && cp->due(t)) cp->submit(t, capture_checkpoint(e, t+dt, dt, t_end, ow));
     }
 
     auto coe=body_to_coe_eci(e.bodies[0]);
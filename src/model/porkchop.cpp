@@ -0,0 +1,136 @@
+#include "model/porkchop.hpp"
+#include "core/geodesy.hpp"
+#include "core/parallel.hpp"
+#include "orbit/lambert.hpp"
+#include "physics/secular.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418;
+static constexpr double DAY_S = 86400.0;
+
+struct PorkchopCell{
+    double dv1 = NAN, dv2 = NAN;    // km/s, departure and arrival burns
+    int rev = -1;
+    double total() const { return dv1 + dv2; }
+};
+
+static size_t grid_count(double lo, double hi, double step){
+    return (size_t)std::floor((hi - lo)/step + 1e-9) + 1;
+}
+
+static int body_index(const PhysicsEngine& e, const std::string& name, int fallback){
+    if(name.empty()) return fallback < (int)e.bodies.size() ? fallback : -1;
+    for(size_t i=0;i<e.names.size();i++) if(e.names[i] == name) return (int)i;
+    return -1;
+}
+
+// Cheapest (departure + arrival) revolution count for one cell, flown in
+// the departure orbit's sense about +z.
+static PorkchopCell solve_cell(const Body& c, const Body& t, double tof_s, int max_rev, LambertMethod method){
+    PorkchopCell cell;
+    const bool retrograde = (c.x*c.vy - c.y*c.vx) < 0.0;
+    const auto sols = lambert_intercept({c.x, c.y, c.z}, {t.x, t.y, t.z}, tof_s, MU_E_KM3_S2, max_rev, method, retrograde);
+    const size_t k = pick_min_dv_total(sols, {c.vx, c.vy, c.vz}, {t.vx, t.vy, t.vz}, cell.dv1, cell.dv2);
+    if(k < sols.size()) cell.rev = lambert_revolutions(k);
+    return cell;
+}
+
+bool run_porkchop(PhysicsEngine& e, const ScenarioCfg& cfg, const PorkchopOptions& opt){
+    const int ci = body_index(e, opt.chaser, 1), ti = body_index(e, opt.target, 0);
+    if(ci < 0 || ti < 0 || ci == ti){
+        std::cerr << "run_porkchop: need distinct chaser and target entities\n";
+        return false;
+    }
+    if(!(opt.depart_step_h > 0.0) || !(opt.tof_step_h > 0.0) || !(opt.tof_min_h > 0.0)
+       || opt.depart_end_h < opt.depart_start_h || opt.tof_max_h < opt.tof_min_h){
+        std::cerr << "run_porkchop: steps and TOF must be positive, ranges ordered\n";
+        return false;
+    }
+    const double d0 = opt.depart_start_h*3600.0, dd = opt.depart_step_h*3600.0;
+    const double f0 = opt.tof_min_h*3600.0, df = opt.tof_step_h*3600.0;
+    const size_t nd = grid_count(opt.depart_start_h, opt.depart_end_h, opt.depart_step_h);
+    const size_t nf = grid_count(opt.tof_min_h, opt.tof_max_h, opt.tof_step_h);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    SecularCatalog cat;
+    cat.reserve(2);
+    cat.add(e.bodies[ci]);
+    cat.add(e.bodies[ti]);
+
+    std::vector<Body> chaser(nd);
+    cat.states_on_grid(0, d0, dd, nd, chaser.data());
+
+    std::vector<PorkchopCell> cells(nd*nf);
+    work_stealing_for(nd, opt.threads, [&](size_t i){
+        std::vector<Body> target(nf);
+        cat.states_on_grid(1, d0 + i*dd + f0, df, nf, target.data());
+        for(size_t j=0;j<nf;j++)
+            cells[i*nf + j] = solve_cell(chaser[i], target[j], f0 + j*df, opt.max_rev, opt.lambert);
+    });
+
+    std::vector<size_t> row_min(nd, SIZE_MAX);
+    size_t global_min = SIZE_MAX;
+    for(size_t i=0;i<nd;i++){
+        for(size_t j=0;j<nf;j++){
+            const size_t k = i*nf + j;
+            if(cells[k].rev < 0) continue;
+            if(row_min[i] == SIZE_MAX || cells[k].total() < cells[row_min[i]].total()) row_min[i] = k;
+        }
+        if(row_min[i] != SIZE_MAX && (global_min == SIZE_MAX || cells[row_min[i]].total() < cells[global_min].total()))
+            global_min = row_min[i];
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ofstream file;
+    if(!opt.output.empty()){
+        file.open(opt.output);
+        if(!file){
+            std::cerr << "run_porkchop: cannot write " << opt.output << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    out << "depart_jd,depart_utc,tof_s,arrive_utc,rev,dv_depart_m_s,dv_arrive_m_s,dv_total_m_s,min\n";
+    char num[200];
+    for(size_t i=0;i<nd;i++){
+        const double dep_jd = cfg.epoch_jd + (d0 + i*dd)/DAY_S;
+        const std::string dep_utc = jd_to_utc(dep_jd, true);
+        for(size_t j=0;j<nf;j++){
+            const size_t k = i*nf + j;
+            const PorkchopCell& c = cells[k];
+            const double tof = f0 + j*df;
+            const char* mark = k == global_min ? "global" : k == row_min[i] ? "row" : "";
+            std::snprintf(num, sizeof(num), "%.8f,%s,%.1f,%s,%d,%.3f,%.3f,%.3f,%s",
+                          dep_jd, dep_utc.c_str(), tof, jd_to_utc(dep_jd + tof/DAY_S, true).c_str(),
+                          c.rev, c.dv1*1000.0, c.dv2*1000.0, c.total()*1000.0, mark);
+            out << num << "\n";
+        }
+    }
+
+    if(!opt.output.empty()){
+        std::cout << "porkchop chaser " << e.names[ci]
+                  << " target " << e.names[ti]
+                  << " departures " << nd
+                  << " tofs " << nf
+                  << " elapsed_s " << elapsed << "\n";
+        if(global_min != SIZE_MAX){
+            const size_t i = global_min/nf, j = global_min%nf;
+            std::cout << "porkchop min dv_total_m_s " << cells[global_min].total()*1000.0
+                      << " depart_utc " << jd_to_utc(cfg.epoch_jd + (d0 + i*dd)/DAY_S, true)
+                      << " tof_s " << f0 + j*df
+                      << " rev " << cells[global_min].rev << "\n";
+        }
+        std::cout << "porkchop table written: " << opt.output << "\n";
+    }
+    return (bool)out;
+}
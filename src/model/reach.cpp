@@ -0,0 +1,211 @@
+#include "model/reach.hpp"
+#include "core/geodesy.hpp"
+#include "core/parallel.hpp"
+#include "core/strings.hpp"
+#include "core/tle.hpp"
+#include "core/tle_to_coe.hpp"
+#include "orbit/lambert.hpp"
+#include "physics/secular.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
+static constexpr double DAY_S = 86400.0;
+// Warm starts pay off once a TOF step moves both objects by less than this
+// fraction of an orbit; on coarser grids the extrapolated seed is worse
+// than Izzo's own guess.
+static constexpr double WARM_MAX_STEP_PERIODS = 0.05;
+
+struct ReachObject{
+    size_t tle;
+    double a, e;
+    double hx, hy, hz;      // orbit normal
+};
+
+struct ReachResult{
+    size_t chaser, target;  // catalog indices
+    double dv1 = 0.0, dv2 = 0.0, tof = 0.0;
+    int rev = 0;
+    bool found = false;
+    double total() const { return dv1 + dv2; }
+};
+
+// Plane change alone, made where either orbit is slowest (its apogee).
+static double plane_change_bound(const ReachObject& a, const ReachObject& b){
+    const double c = std::clamp(a.hx*b.hx + a.hy*b.hy + a.hz*b.hz, -1.0, 1.0);
+    const double v_apo = std::min(std::sqrt(MU_E_KM3_S2/a.a*(1.0 - a.e)/(1.0 + a.e)),
+                                  std::sqrt(MU_E_KM3_S2/b.a*(1.0 - b.e)/(1.0 + b.e)));
+    return 2.0*v_apo*std::sqrt(0.5*(1.0 - c));
+}
+
+// Hohmann transfer between circular orbits of the two semi-major axes.
+static double altitude_change_bound(const ReachObject& a, const ReachObject& b){
+    const double r1 = std::min(a.a, b.a), r2 = std::max(a.a, b.a);
+    const double at = 0.5*(r1 + r2);
+    const double v1 = std::sqrt(MU_E_KM3_S2/r1), v2 = std::sqrt(MU_E_KM3_S2/r2);
+    return std::sqrt(MU_E_KM3_S2*(2.0/r1 - 1.0/at)) - v1 + v2 - std::sqrt(MU_E_KM3_S2*(2.0/r2 - 1.0/at));
+}
+
+// Scans the TOF cells of one pair in order; on fine grids each Izzo solve
+// is seeded from the previous cells. Returns Householder iterations.
+static size_t solve_pair(const SecularCatalog& cat, const std::vector<ReachObject>& objs,
+                         size_t c, size_t t, const Body& chaser,
+                         double f0, double df, size_t nf, const ReachOptions& opt, ReachResult& res){
+    std::vector<Body> target(nf);
+    cat.states_on_grid(t, f0, df, nf, target.data());
+    const bool retrograde = (chaser.x*chaser.vy - chaser.y*chaser.vx) < 0.0;
+    const double a_min = std::min(objs[c].a, objs[t].a);
+    const double period = 2.0*M_PI*std::sqrt(a_min*a_min*a_min/MU_E_KM3_S2);
+    const bool seeded = opt.warm_start && df <= WARM_MAX_STEP_PERIODS*period;
+    LambertWarmStart warm;
+    size_t iters = 0;
+    res.found = false;
+    for(size_t j=0;j<nf;j++){
+        const double tof = f0 + j*df;
+        if(!seeded) warm.x.clear();
+        const auto sols = lambert_izzo({chaser.x, chaser.y, chaser.z}, {target[j].x, target[j].y, target[j].z},
+                                       tof, MU_E_KM3_S2, opt.max_rev, retrograde, &warm);
+        iters += warm.iterations;
+        double dv1, dv2;
+        const size_t k = pick_min_dv_total(sols, {chaser.vx, chaser.vy, chaser.vz},
+                                           {target[j].vx, target[j].vy, target[j].vz}, dv1, dv2);
+        if(k == sols.size()) continue;
+        if(!res.found || dv1 + dv2 < res.total()){
+            res.dv1 = dv1; res.dv2 = dv2; res.tof = tof;
+            res.rev = lambert_revolutions(k);
+            res.found = true;
+        }
+    }
+    res.chaser = c;
+    res.target = t;
+    return iters;
+}
+
+bool run_reach(const std::string& tle_path, const ReachOptions& opt){
+    std::vector<TLE> tles;
+    if(!load_tles_from_file(tle_path, tles)){
+        std::cerr << "run_reach: failed to read " << tle_path << "\n";
+        return false;
+    }
+    if(!(opt.tof_step_h > 0.0) || !(opt.tof_min_h > 0.0) || opt.tof_max_h < opt.tof_min_h){
+        std::cerr << "run_reach: TOF range must be positive and ordered\n";
+        return false;
+    }
+
+    double jd0 = opt.start_jd;
+    if(jd0 <= 0.0) for(const auto& t : tles) jd0 = std::max(jd0, t.epoch_jd);
+
+    // TLE mean elements taken as secular-J2 mean elements at each epoch.
+    SecularCatalog cat;
+    std::vector<ReachObject> objs;
+    cat.reserve(tles.size());
+    for(size_t i=0;i<tles.size();i++){
+        COE c{};
+        tle_to_coe(tles[i], MU_E_KM3_S2, c);
+        if(!(c.a > 0.0) || !(c.e < 1.0)) continue;
+        c.ta = true_from_mean(tles[i].M_rad, c.e);
+        const double t_epoch = (tles[i].epoch_jd - jd0)*DAY_S;
+        cat.add(c, 0.0, t_epoch);
+        const COE m = cat.elements_at(cat.size() - 1, 0.0);
+        objs.push_back({i, m.a, m.e,
+                        std::sin(m.i)*std::sin(m.raan), -std::sin(m.i)*std::cos(m.raan), std::cos(m.i)});
+    }
+
+    std::vector<size_t> chasers;
+    std::stringstream names(opt.chasers);
+    std::string name;
+    while(std::getline(names, name, ',')){
+        if(name.empty()) continue;
+        size_t k = 0;
+        while(k < objs.size() && trimmed(tles[objs[k].tle].name) != name) k++;
+        if(k == objs.size()){
+            std::cerr << "run_reach: chaser '" << name << "' not in catalog\n";
+            return false;
+        }
+        chasers.push_back(k);
+    }
+    if(chasers.empty()){
+        std::cerr << "run_reach: no chasers given\n";
+        return false;
+    }
+
+    const double f0 = opt.tof_min_h*3600.0, df = opt.tof_step_h*3600.0;
+    const size_t nf = (size_t)std::floor((opt.tof_max_h - opt.tof_min_h)/opt.tof_step_h + 1e-9) + 1;
+    const double max_dv = opt.max_dv_m_s/1000.0;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<ReachResult> work;
+    size_t pruned_plane = 0, pruned_altitude = 0;
+    for(size_t c : chasers){
+        for(size_t t=0;t<objs.size();t++){
+            if(t == c) continue;
+            if(plane_change_bound(objs[c], objs[t]) > max_dv){ pruned_plane++; continue; }
+            if(altitude_change_bound(objs[c], objs[t]) > max_dv){ pruned_altitude++; continue; }
+            ReachResult r;
+            r.chaser = c;
+            r.target = t;
+            work.push_back(r);
+        }
+    }
+
+    std::vector<Body> chaser_state(objs.size());
+    for(size_t c : chasers) cat.state_at(c, 0.0, chaser_state[c]);
+    std::vector<size_t> iters(work.size());
+    work_stealing_for(work.size(), opt.threads, [&](size_t i){
+        ReachResult& r = work[i];
+        iters[i] = solve_pair(cat, objs, r.chaser, r.target, chaser_state[r.chaser], f0, df, nf, opt, r);
+    });
+
+    std::vector<ReachResult> reachable;
+    size_t total_iters = 0;
+    for(size_t i=0;i<work.size();i++){
+        total_iters += iters[i];
+        if(work[i].found && work[i].total() <= max_dv) reachable.push_back(work[i]);
+    }
+    std::sort(reachable.begin(), reachable.end(), [](const ReachResult& a, const ReachResult& b){
+        if(a.chaser != b.chaser) return a.chaser < b.chaser;
+        if(a.total() != b.total()) return a.total() < b.total();
+        return a.target < b.target;
+    });
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::ofstream file;
+    if(!opt.output.empty()){
+        file.open(opt.output);
+        if(!file){
+            std::cerr << "run_reach: cannot write " << opt.output << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    out << "chaser,target,dv_total_m_s,dv_depart_m_s,dv_arrive_m_s,tof_s,rev,arrive_utc\n";
+    char num[200];
+    for(const auto& r : reachable){
+        std::snprintf(num, sizeof(num), "%.3f,%.3f,%.3f,%.1f,%d,%s",
+                      r.total()*1000.0, r.dv1*1000.0, r.dv2*1000.0, r.tof, r.rev,
+                      jd_to_utc(jd0 + r.tof/DAY_S, true).c_str());
+        out << trimmed(tles[objs[r.chaser].tle].name) << ","
+            << trimmed(tles[objs[r.target].tle].name) << "," << num << "\n";
+    }
+
+    if(!opt.output.empty()){
+        const size_t cells = work.size()*nf;
+        std::cout << "reach chasers " << chasers.size()
+                  << " targets " << objs.size()
+                  << " pruned_plane " << pruned_plane
+                  << " pruned_altitude " << pruned_altitude
+                  << " solved " << work.size()
+                  << " reachable " << reachable.size()
+                  << " householder_iters_per_cell " << (cells ? (double)total_iters/cells : 0.0)
+                  << " elapsed_s " << elapsed << "\n";
+        std::cout << "reach table written: " << opt.output << "\n";
+    }
+    return (bool)out;
+}
@@ -28,6 +28,11 @@ struct PlanResult{
     double lead_tau_s = 4000.0;
 };
 
+// Drag surface for the rocket body, when the scenario gives one.
+static void apply_rocket_aero(Rocket& r, const PhysicsEngine& e, size_t idx){
+    if(idx < e.surfaces.size()) r.set_aero(e.surfaces[idx].area_m2, e.surfaces[idx].cd);
+}
+
 static double simulate_coarse_cost(const PhysicsEngine& e0,
                                   double dt,
                                   double t_end,
@@ -61,6 +66,7 @@ static double simulate_coarse_cost(const PhysicsEngine& e0,
     Body ace = e0.bodies[(size_t)ace_idx];
 
     const Body r0 = e0.bodies[(size_t)rocket_idx];
+    apply_rocket_aero(r, e0, (size_t)rocket_idx);
 
     RocketState rs{};
     rs.x=r0.x; rs.y=r0.y; rs.z=r0.z;
@@ -149,7 +155,11 @@ static inline void orbital_diags(const RocketState& s, double& v_km_s, double& e
     }
 }
 
-static void final_run(const PhysicsEngine& e0, double dt, double t_end, double thrust_scale, double lead_tau_s, OutputWriter* ow){
+// model_state layout for checkpoints of final_run
+enum RocketModelState{ RMS_THRUST_SCALE, RMS_LEAD_TAU, RMS_CUTOFF, RMS_PREV_RANGE, RMS_LAST_PRINT, RMS_BEST_RANGE, RMS_BEST_T, RMS_COUNT };
+
+static void final_run(PhysicsEngine& e0, double dt, double t_end, double thrust_scale, double lead_tau_s, OutputWriter* ow,
+                      Checkpointer* cp, const Checkpoint* resume, std::ostream& log){
     std::vector<Stage> stages{
         {7.6e6*thrust_scale,263,395000,25600},
         {9.34e5*thrust_scale,421,92670,4000},
@@ -160,6 +170,7 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
 
     Body ace = e0.bodies[0];
     const Body r0 = e0.bodies[1];
+    apply_rocket_aero(r, e0, 1);
 
     RocketState rs{};
     rs.x=r0.x; rs.y=r0.y; rs.z=r0.z;
@@ -177,7 +188,20 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
     double best_range = std::numeric_limits<double>::infinity();
     double best_t = 0.0;
 
-    for(double t=0;t<=t_end;t+=dt){
+    double t0 = 0.0, t_last = 0.0;
+    if(resume && resume->has_rocket && resume->model_state.size() >= RMS_COUNT && !resume->bodies.empty()){
+        const auto& ms = resume->model_state;
+        r.restore(resume->rocket);
+        ace = resume->bodies[0];
+        cutoff_announced = ms[RMS_CUTOFF] != 0.0;
+        prev_range   = ms[RMS_PREV_RANGE];
+        last_print_t = ms[RMS_LAST_PRINT];
+        best_range   = ms[RMS_BEST_RANGE];
+        best_t       = ms[RMS_BEST_T];
+        t0 = resume->t;
+    }
+
+    for(double t=t0;t<=t_end;t+=dt){
         if(t>0.0) step_body_central(ace, dt);
 
         const double tp[3] = { ace.x + ace.vx*lead_tau_s,
@@ -188,6 +212,7 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
         r.step(dt, MU_E_KM3_S2, tp, tv, lead_tau_s);
 
         auto s = r.state();
+        t_last = t;
 
         // Suborbital cutoff: once we can reach GEO-radius apogee (two-body estimate), stop thrust and coast
         double v_km_s=0, eps=0, a_km=0, ecc=0, rp_km=0, ra_km=0;
@@ -199,7 +224,7 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
         if(!cutoff_announced && r.has_thrust() && alt_km > 150.0 && std::isfinite(ra_km) && ra_km >= r_target_km){
             r.force_cutoff();
             cutoff_announced=true;
-            std::cout<<"t "<<t<<" ROCKET_CUTOFF reason apogee_reached ra_km "<<ra_km<<" target_ra_km "<<r_target_km<<"\n";
+            log<<"t "<<t<<" ROCKET_CUTOFF reason apogee_reached ra_km "<<ra_km<<" target_ra_km "<<r_target_km<<"\n";
         }
 
         // Metrics vs Ace
@@ -215,6 +240,8 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
 
         if(ow && ow->enabled()){
             PhysicsEngine tmp;
+            tmp.epoch_jd = e0.epoch_jd;
+            tmp.time = t;           // Ace has been stepped to t
             tmp.bodies.resize(2);
             tmp.names.resize(2);
             tmp.bodies[0] = ace;
@@ -237,7 +264,7 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
             if(prev_range >= 0.0) rr_num = (range - prev_range) / 60.0;
             prev_range = range;
 
-            std::cout<<"t "<<t<<" rocket_alt_km "<<alt_km
+            log<<"t "<<t<<" rocket_alt_km "<<alt_km
                      <<" rocket_v_km_s "<<v_km_s
                      <<" eps_km2_s2 "<<eps
                      <<" a_km "<<a_km
@@ -245,19 +272,49 @@ static void final_run(const PhysicsEngine& e0, double dt, double t_end, double t
                      <<" ra_km "<<ra_km
                      <<" rp_km "<<rp_km<<"\n";
 
-            std::cout<<"t "<<t<<" rocket_to_ace_range_km "<<range
+            log<<"t "<<t<<" rocket_to_ace_range_km "<<range
                      <<" rr_vec_km_s "<<rr_vec
                      <<" rr_num_km_s "<<rr_num
                      <<" lead_tau_s "<<lead_tau_s
                      <<" thrust_scale "<<thrust_scale
                      <<" powered "<<(r.has_thrust()?1:0)<<"\n";
         }
+
+        if(cp && cp->due(t)){
+            PhysicsEngine snap;
+            snap.add(ace, "Ace");
+            snap.add(Body{ s.x,s.y,s.z, s.vx,s.vy,s.vz, s.mass }, "Rocket");
+            Checkpoint c = capture_checkpoint(snap, t+dt, dt, t_end, ow);
+            c.has_rocket = true;
+            c.rocket = r.checkpoint();
+            c.model_state.assign(RMS_COUNT, 0.0);
+            c.model_state[RMS_THRUST_SCALE] = thrust_scale;
+            c.model_state[RMS_LEAD_TAU]     = lead_tau_s;
+            c.model_state[RMS_CUTOFF]       = cutoff_announced ? 1.0 : 0.0;
+            c.model_state[RMS_PREV_RANGE]   = prev_range;
+            c.model_state[RMS_LAST_PRINT]   = last_print_t;
+            c.model_state[RMS_BEST_RANGE]   = best_range;
+            c.model_state[RMS_BEST_T]       = best_t;
+            cp->submit(t, std::move(c));
+        }
     }
 
-    std::cout<<"CLOSEST_APPROACH t "<<best_t<<" range_km "<<best_range<<"\n";
+    log<<"CLOSEST_APPROACH t "<<best_t<<" range_km "<<best_range<<"\n";
+
+    const auto s = r.state();
+    e0.bodies[0] = ace;
+    e0.bodies[1] = Body{ s.x,s.y,s.z, s.vx,s.vy,s.vz, s.mass };
+    e0.time = t_last;
 }
 
-void run_rocket_model(PhysicsEngine& e, double dt, double t_end, OutputWriter* ow){
+void run_rocket_model(PhysicsEngine& e, double dt, double t_end, OutputWriter* ow,
+                      Checkpointer* cp, const Checkpoint* resume, std::ostream& log){
+    // A resumed run reuses the plan chosen before the checkpoint.
+    if(resume && resume->model_state.size() >= RMS_COUNT){
+        final_run(e, dt, t_end, resume->model_state[RMS_THRUST_SCALE], resume->model_state[RMS_LEAD_TAU], ow, cp, resume, log);
+        return;
+    }
+
     const double t_search = std::min(t_end, 6.0*3600.0);
     const double dt_search = std::max(2.0, dt);
 
@@ -280,10 +337,10 @@ void run_rocket_model(PhysicsEngine& e, double dt, double t_end, OutputWriter* o
         }
     }
 
-    std::cout<<"AUTO_PLAN best_thrust_scale "<<best.thrust_scale
+    log<<"AUTO_PLAN best_thrust_scale "<<best.thrust_scale
              <<" best_lead_tau_s "<<best.lead_tau_s
              <<" best_miss_km "<<best.miss_km
              <<" best_tca_s "<<best.tca_s<<"\n";
 
-    final_run(e, dt, t_end, best.thrust_scale, best.lead_tau_s, ow);
+    final_run(e, dt, t_end, best.thrust_scale, best.lead_tau_s, ow, cp, nullptr, log);
 }
@@ -0,0 +1,60 @@
+#include "model/secular_model.hpp"
+#include "core/environment.hpp"
+#include "core/vector.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/orbit.hpp"
+#include "physics/secular.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+static constexpr double REPORT_EVERY_S = 3600.0;
+
+static std::array<double,3> pos(const Body& b){ return {b.x,b.y,b.z}; }
+
+void run_secular_model(PhysicsEngine& e,double t_end,OutputWriter* ow,std::ostream& log){
+    if(e.bodies.empty()) return;
+    auto& env=Environment::instance();
+    const auto t0 = std::chrono::steady_clock::now();
+
+    SecularCatalog cat;
+    cat.reserve(e.bodies.size());
+    for(const auto& b : e.bodies) cat.add(b);
+
+    size_t evaluations = 0;
+    double t = 0.0;
+    double next_report = 0.0;
+    while(true){
+        cat.states_at(t, e.bodies.data());
+        e.time = t;
+        evaluations++;
+
+        if(ow && ow->enabled()) ow->tick(t,e);
+
+        if(t >= next_report){
+            if(e.ephemeris) refresh_environment(*e.ephemeris, t);
+            auto sat=pos(e.bodies[0]);
+            for(const auto& kv : env.all()){
+                auto v=vec_between(sat,pos(kv.second.body));
+                log<<"t "<<t<<" target "<<kv.first
+                         <<" dist_km "<<vec_mag(v)
+                         <<" angle_deg "<<vec_angle_deg(sat,v)<<"\n";
+            }
+            next_report += REPORT_EVERY_S;
+        }
+
+        if(t >= t_end) break;
+        double next = next_report;
+        if(ow && ow->enabled()) next = std::min(next, ow->next_time());
+        t = std::min(next, t_end);
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    auto coe=body_to_coe_eci(e.bodies[0]);
+    log<<"final_coe a_km "<<coe.a<<" e "<<coe.e<<" i_rad "<<coe.i
+             <<" raan_rad "<<coe.raan<<" argp_rad "<<coe.argp<<" ta_rad "<<coe.ta<<"\n";
+    log<<"secular_j2 bodies "<<e.bodies.size()<<" evaluations "<<evaluations
+             <<" elapsed_s "<<elapsed<<"\n";
+}
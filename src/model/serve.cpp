@@ -0,0 +1,430 @@
+#include "model/serve.hpp"
+#include "core/parallel.hpp"
+#include "core/strings.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/secular.hpp"
+#include "sim/local_socket.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418;
+static constexpr double JD_UNIX_EPOCH = 2440587.5;
+static constexpr size_t MAX_REQUEST_BYTES = 1u<<16;
+static constexpr size_t MAX_REPLY_BYTES = 64u<<20;
+// Secular node/perigee drift adds well under 1% to the two-body
+// acceleration bound used for extrapolation.
+static constexpr double ACCEL_MARGIN = 1.05;
+static constexpr double EPH_DIFF_S = 30.0;
+
+static volatile std::sig_atomic_t stop_requested = 0;
+static void on_stop_signal(int){ stop_requested = 1; }
+
+// Whole-catalog states at one grid time.
+struct GridStates{
+    long long slot = 0;
+    double t = 0.0;
+    uint64_t used = 0;
+    std::vector<Body> bodies;
+};
+
+struct Hit{
+    double range, rate;
+    size_t k;
+};
+
+struct ServeClient{
+    int fd = -1;
+    std::string inbox, outbox;
+    size_t sent = 0;
+    bool closing = false;   // QUIT or EOF seen: drain outbox, then close
+};
+
+struct ServeState{
+    ServeState(const PhysicsEngine& e, const ScenarioCfg& cfg, const ServeOptions& opt) : e(e), cfg(cfg), opt(opt) {}
+
+    const PhysicsEngine& e;
+    const ScenarioCfg& cfg;
+    const ServeOptions& opt;
+    SecularCatalog cat;
+    std::unordered_map<std::string, size_t> index;
+    std::vector<double> half_accel;     // 0.5 * max |a| over the orbit, km/s^2
+    std::vector<GridStates> grid;
+    uint64_t use_clock = 0;
+    size_t grid_hits = 0, grid_misses = 0;
+    std::vector<double> lin, bound, upper;  // per-query scratch
+    std::vector<Hit> hits;
+};
+
+static bool parse_time(const std::string& tok, double epoch_jd, double& t){
+    if(tok == "now"){
+        const double unix_s = std::chrono::duration<double>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        t = (JD_UNIX_EPOCH + unix_s/86400.0 - epoch_jd)*86400.0;
+        return true;
+    }
+    const bool jd = tok.compare(0, 3, "jd:") == 0;
+    const char* s = tok.c_str() + (jd ? 3 : 0);
+    char* end = nullptr;
+    const double v = std::strtod(s, &end);
+    if(end == s || *end || !std::isfinite(v)) return false;
+    t = jd ? (v - epoch_jd)*86400.0 : v;
+    return true;
+}
+
+// Cached states at the grid time nearest t, computed on first use and
+// evicted least recently used.
+static const GridStates& grid_states(ServeState& st, double t){
+    const long long slot = std::llround(t/st.opt.grid_s);
+    for(auto& g : st.grid){
+        if(g.slot == slot && !g.bodies.empty()){
+            g.used = ++st.use_clock;
+            st.grid_hits++;
+            return g;
+        }
+    }
+    st.grid_misses++;
+    GridStates* g = nullptr;
+    if(st.grid.size() < std::max<size_t>(1, st.opt.cache_states)){
+        st.grid.emplace_back();
+        g = &st.grid.back();
+    }else{
+        g = &*std::min_element(st.grid.begin(), st.grid.end(),
+                               [](const GridStates& a, const GridStates& b){ return a.used < b.used; });
+    }
+    g->slot = slot;
+    g->t = (double)slot*st.opt.grid_s;
+    g->used = ++st.use_clock;
+    g->bodies.resize(st.cat.size());
+    parallel_for(st.cat.size(), 2048, [&](size_t b, size_t e, size_t){
+        for(size_t k=b;k<e;k++) st.cat.state_at(k, g->t, g->bodies[k]);
+    });
+    return *g;
+}
+
+static void range_of(const Body& ref, const Body& b, double& range, double& rate){
+    const double dx = b.x - ref.x, dy = b.y - ref.y, dz = b.z - ref.z;
+    range = std::sqrt(dx*dx + dy*dy + dz*dz);
+    rate = range > 0.0 ? (dx*(b.vx - ref.vx) + dy*(b.vy - ref.vy) + dz*(b.vz - ref.vz))/range : 0.0;
+}
+
+// Every object other than `ref_k` whose range at t can be at most `limit`
+// (limit < 0: the `n` nearest), exact, closest first.
+static void screen(ServeState& st, size_t ref_k, double t, double limit, size_t n){
+    const GridStates& g = grid_states(st, t);
+    const double dt = t - g.t;
+    Body ref;
+    st.cat.state_at(ref_k, t, ref);
+
+    const size_t count = st.cat.size();
+    st.lin.resize(count);
+    st.bound.resize(count);
+    for(size_t k=0;k<count;k++){
+        const Body& b = g.bodies[k];
+        const double dx = b.x + b.vx*dt - ref.x;
+        const double dy = b.y + b.vy*dt - ref.y;
+        const double dz = b.z + b.vz*dt - ref.z;
+        st.lin[k] = std::sqrt(dx*dx + dy*dy + dz*dz);
+        st.bound[k] = st.half_accel[k]*dt*dt;
+    }
+    st.lin[ref_k] = std::numeric_limits<double>::infinity();
+
+    if(limit < 0.0){
+        n = std::min(n, count - 1);
+        if(n == 0){ st.hits.clear(); return; }
+        st.upper.resize(count);
+        for(size_t k=0;k<count;k++) st.upper[k] = st.lin[k] + st.bound[k];
+        std::nth_element(st.upper.begin(), st.upper.begin() + (n - 1), st.upper.end());
+        limit = st.upper[n - 1];
+    }
+
+    st.hits.clear();
+    Body b;
+    for(size_t k=0;k<count;k++){
+        if(k == ref_k || st.lin[k] - st.bound[k] > limit) continue;
+        st.cat.state_at(k, t, b);
+        Hit h{0.0, 0.0, k};
+        range_of(ref, b, h.range, h.rate);
+        if(h.range <= limit) st.hits.push_back(h);
+    }
+    std::sort(st.hits.begin(), st.hits.end(), [](const Hit& a, const Hit& b){ return a.range < b.range; });
+    if(n && st.hits.size() > n) st.hits.resize(n);
+}
+
+static void reply_hits(const ServeState& st, std::string& out){
+    char row[256];
+    out += "OK " + std::to_string(st.hits.size()) + "\n";
+    for(const Hit& h : st.hits){
+        std::snprintf(row, sizeof(row), ",%.6f,%.9f\n", h.range, h.rate);
+        out += trimmed(st.e.names[h.k]);
+        out += row;
+    }
+}
+
+// Appends the reply for one request line; false for QUIT.
+static bool answer(ServeState& st, const std::string& line, std::string& out){
+    std::istringstream in(line);
+    std::string cmd, when, name;
+    if(!(in >> cmd)) return true;
+    if(cmd == "QUIT") return false;
+    if(cmd == "INFO"){
+        char row[256];
+        std::snprintf(row, sizeof(row), "OK 1\nbodies,%zu,epoch_jd,%.8f,grid_s,%g,cached,%zu,grid_hits,%zu,grid_misses,%zu\n",
+                      st.cat.size(), st.cfg.epoch_jd, st.opt.grid_s, st.grid.size(), st.grid_hits, st.grid_misses);
+        out += row;
+        return true;
+    }
+
+    double t = 0.0, arg = 0.0;
+    if(cmd != "STATE" && cmd != "NEAREST" && cmd != "WITHIN"){
+        out += "ERR unknown request '" + cmd + "'\n";
+        return true;
+    }
+    if(!(in >> when) || !parse_time(when, st.cfg.epoch_jd, t)){
+        out += "ERR bad time (seconds since epoch, jd:<date> or now)\n";
+        return true;
+    }
+    if(cmd != "STATE" && !(in >> arg && arg >= 0.0)){
+        out += "ERR " + cmd + " needs a non-negative " + (cmd == "NEAREST" ? "count" : "radius_km") + "\n";
+        return true;
+    }
+    std::getline(in >> std::ws, name);
+    name = trimmed(name);
+    const auto it = st.index.find(name);
+
+    if(cmd == "STATE"){
+        Body b;
+        if(it != st.index.end()){
+            st.cat.state_at(it->second, t, b);
+        }else{
+            const Ephemeris* eph = st.e.ephemeris.get();
+            const int idx = eph ? eph->index(name) : -1;
+            if(idx >= 0 && t >= 0.0 && t <= eph->span_s()){
+                double r[3], v[3];
+                eph->state(idx, t, r, v);
+                b.x = r[0]; b.y = r[1]; b.z = r[2];
+                b.vx = v[0]; b.vy = v[1]; b.vz = v[2];
+            }else{
+                // outside the fitted window: the series itself, velocity by central difference
+                const double jd = st.cfg.epoch_jd + t/86400.0, h = EPH_DIFF_S/86400.0;
+                std::array<double,3> r, rm, rp;
+                if(!analytic_body_eci_km(name, jd, r)){
+                    out += "ERR unknown object '" + name + "'\n";
+                    return true;
+                }
+                analytic_body_eci_km(name, jd - h, rm);
+                analytic_body_eci_km(name, jd + h, rp);
+                b.x = r[0]; b.y = r[1]; b.z = r[2];
+                b.vx = (rp[0] - rm[0])/(2.0*EPH_DIFF_S);
+                b.vy = (rp[1] - rm[1])/(2.0*EPH_DIFF_S);
+                b.vz = (rp[2] - rm[2])/(2.0*EPH_DIFF_S);
+            }
+        }
+        char row[320];
+        std::snprintf(row, sizeof(row), ",%.3f,%.6f,%.6f,%.6f,%.9f,%.9f,%.9f\n",
+                      t, b.x, b.y, b.z, b.vx, b.vy, b.vz);
+        out += "OK 1\n" + name + row;
+        return true;
+    }
+
+    if(it == st.index.end()){
+        out += "ERR unknown catalog object '" + name + "'\n";
+        return true;
+    }
+    // Clamped first: a count past the catalog (or 2^64) would not convert.
+    if(cmd == "NEAREST") screen(st, it->second, t, -1.0, (size_t)std::min(arg, (double)st.cat.size()));
+    else screen(st, it->second, t, arg, 0);
+    reply_hits(st, out);
+    return true;
+}
+
+// Reads and answers complete request lines; false on a socket error or an
+// oversized request or reply. QUIT or EOF only marks the client closing.
+static bool read_client(ServeState& st, ServeClient& c, size_t& queries, double& busy_s, double& worst_s){
+    char buf[4096];
+    for(;;){
+        const ssize_t n = ::recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if(n == 0){
+            c.closing = true;
+            break;
+        }
+        if(n < 0){
+            if(errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        c.inbox.append(buf, (size_t)n);
+        if(c.inbox.size() > MAX_REQUEST_BYTES) return false;
+    }
+    size_t nl;
+    while((nl = c.inbox.find('\n')) != std::string::npos){
+        const std::string line = c.inbox.substr(0, nl);
+        c.inbox.erase(0, nl + 1);
+        const auto q0 = std::chrono::steady_clock::now();
+        const bool more = answer(st, line, c.outbox);
+        const double q = std::chrono::duration<double>(std::chrono::steady_clock::now() - q0).count();
+        queries++;
+        busy_s += q;
+        worst_s = std::max(worst_s, q);
+        if(!more){
+            c.closing = true;
+            c.inbox.clear();
+            break;
+        }
+    }
+    return c.outbox.size() - c.sent <= MAX_REPLY_BYTES;
+}
+
+static bool flush_client(ServeClient& c){
+    while(c.sent < c.outbox.size()){
+        const ssize_t n = ::send(c.fd, c.outbox.data() + c.sent, c.outbox.size() - c.sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c.sent += (size_t)n;
+    }
+    c.outbox.clear();
+    c.sent = 0;
+    return true;
+}
+
+bool run_serve(PhysicsEngine& e, const ScenarioCfg& cfg, const ServeOptions& opt){
+    if(e.bodies.empty()){
+        std::cerr << "run_serve: scenario has no bodies\n";
+        return false;
+    }
+    if(!(opt.grid_s > 0.0)){
+        std::cerr << "run_serve: grid spacing must be positive\n";
+        return false;
+    }
+    if(e.names.size() < e.bodies.size()){
+        std::cerr << "run_serve: scenario bodies are unnamed\n";
+        return false;
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    ServeState st{e, cfg, opt};
+    st.cat.reserve(e.bodies.size());
+    st.half_accel.reserve(e.bodies.size());
+    for(size_t k=0;k<e.bodies.size();k++){
+        st.cat.add(e.bodies[k]);
+        const COE c = st.cat.elements_at(k, 0.0);
+        const double rp = c.a*(1.0 - c.e);
+        st.half_accel.push_back(rp > 0.0 && c.e < 1.0 ? 0.5*ACCEL_MARGIN*MU_E_KM3_S2/(rp*rp)
+                                                      : std::numeric_limits<double>::max());
+        st.index.emplace(trimmed(e.names[k]), k);
+    }
+
+    std::string unix_path;
+    const int listen_fd = local_listen(opt.endpoint, unix_path, "serve");
+    if(listen_fd < 0) return false;
+    const double ready_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "serve listening on " << opt.endpoint << " bodies " << st.cat.size()
+              << " catalog_ms " << ready_ms << std::endl;
+
+    stop_requested = 0;
+    auto prev_int = std::signal(SIGINT, on_stop_signal);
+    auto prev_term = std::signal(SIGTERM, on_stop_signal);
+
+    std::vector<ServeClient> clients;
+    std::vector<pollfd> fds;
+    size_t queries = 0, connections = 0;
+    double busy_s = 0.0, worst_s = 0.0;
+    while(!stop_requested){
+        fds.assign(1, pollfd{listen_fd, POLLIN, 0});
+        for(const auto& c : clients)
+            fds.push_back(pollfd{c.fd, (short)((c.closing ? 0 : POLLIN) | (c.outbox.empty() ? 0 : POLLOUT)), 0});
+        if(::poll(fds.data(), fds.size(), 200) < 0 && errno != EINTR) break;
+
+        for(size_t k=0;k<clients.size();k++){
+            ServeClient& c = clients[k];
+            bool ok = true;
+            if(!c.closing && (fds[k+1].revents & (POLLIN | POLLHUP | POLLERR)))
+                ok = read_client(st, c, queries, busy_s, worst_s);
+            const bool sent = flush_client(c);
+            // A closing client stays polled for POLLOUT until its reply is out.
+            if(!ok || !sent || (c.closing && c.outbox.empty())){
+                ::close(c.fd);
+                c.fd = -1;
+            }
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const ServeClient& c){ return c.fd < 0; }),
+                      clients.end());
+
+        if(fds[0].revents & POLLIN){
+            int fd;
+            while((fd = ::accept(listen_fd, nullptr, nullptr)) >= 0){
+                if(clients.size() >= opt.max_clients){
+                    ::close(fd);
+                    continue;
+                }
+                ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+                clients.push_back(ServeClient{fd, {}, {}, 0, false});
+                connections++;
+            }
+        }
+    }
+
+    for(auto& c : clients) ::close(c.fd);
+    ::close(listen_fd);
+    if(!unix_path.empty()) ::unlink(unix_path.c_str());
+    std::signal(SIGINT, prev_int);
+    std::signal(SIGTERM, prev_term);
+
+    std::cout << "SERVE_DONE connections " << connections << " queries " << queries
+              << " mean_us " << (queries ? 1e6*busy_s/queries : 0.0) << " max_us " << 1e6*worst_s
+              << " grid_hits " << st.grid_hits << " grid_misses " << st.grid_misses << "\n";
+    return true;
+}
+
+bool run_query(const std::string& endpoint, const std::string& request){
+    const int fd = local_connect(endpoint);
+    if(fd < 0){
+        std::cerr << "query: cannot connect to " << endpoint << "\n";
+        return false;
+    }
+    const std::string line = request + "\nQUIT\n";
+    for(size_t off=0; off<line.size();){
+        const ssize_t n = ::send(fd, line.data() + off, line.size() - off, MSG_NOSIGNAL);
+        if(n <= 0){
+            ::close(fd);
+            std::cerr << "query: send failed\n";
+            return false;
+        }
+        off += (size_t)n;
+    }
+    std::string reply;
+    char buf[65536];
+    ssize_t n;
+    while((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) reply.append(buf, (size_t)n);
+    ::close(fd);
+
+    const size_t nl = reply.find('\n');
+    const std::string status = reply.substr(0, nl);
+    if(nl == std::string::npos || status.compare(0, 3, "OK ") != 0){
+        std::cerr << "query: " << (status.empty() ? "no reply" : status) << "\n";
+        return false;
+    }
+    // The status announces the row count; anything else is a cut reply.
+    char* end = nullptr;
+    const unsigned long long want = std::strtoull(status.c_str() + 3, &end, 10);
+    const std::string body = reply.substr(nl + 1);
+    const size_t got = (size_t)std::count(body.begin(), body.end(), '\n');
+    if(end == status.c_str() + 3 || *end || (!body.empty() && body.back() != '\n') || got != want){
+        std::cerr << "query: reply announced " << status.substr(3) << " rows, received " << got << "\n";
+        return false;
+    }
+    std::cout << body;
+    return true;
+}
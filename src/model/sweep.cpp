@@ -0,0 +1,263 @@
+#include "model/sweep.hpp"
+#include "model/rocket_model.hpp"
+#include "model/secular_model.hpp"
+#include "sim/scenario.hpp"
+#include "physics/engine.hpp"
+#include "physics/orbit.hpp"
+#include "physics/ephemeris.hpp"
+#include "core/solarsystem.hpp"
+#include "core/output.hpp"
+#include "core/parallel.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+static constexpr double RAD2DEG = 180.0 / M_PI;
+
+struct SweepAxis{
+    std::string key;
+    std::vector<double> values;
+};
+
+struct SweepSpec{
+    std::string base;
+    std::vector<SweepAxis> axes;
+    std::string report;
+    std::string summary;
+    std::string output_dir;
+    double output_rate = 60.0;
+    size_t threads = 0;
+};
+
+struct SweepResult{
+    bool ok = false;
+    size_t n_bodies = 0;
+    size_t steps = 0;
+    double wall_ms = 0.0;
+    COE coe{};
+};
+
+static bool parse_sweep_spec(const std::string& path, SweepSpec& sp){
+    std::ifstream f(path);
+    if(!f){
+        std::cerr << "sweep: failed to open " << path << "\n";
+        return false;
+    }
+    std::string line;
+    while(std::getline(f,line)){
+        auto hash = line.find('#');
+        if(hash != std::string::npos) line.resize(hash);
+        std::istringstream ss(line);
+        std::string k;
+        ss >> k;
+        if(k.empty()) continue;
+
+        if(k=="base") ss >> sp.base;
+        else if(k=="report") ss >> sp.report;
+        else if(k=="summary") ss >> sp.summary;
+        else if(k=="output_dir") ss >> sp.output_dir;
+        else if(k=="output_rate") ss >> sp.output_rate;
+        else if(k=="threads") ss >> sp.threads;
+        else if(k=="vary"){
+            SweepAxis ax;
+            ss >> ax.key;
+            std::vector<std::string> toks;
+            for(std::string tok; ss >> tok;) toks.push_back(tok);
+            try{
+                if(!toks.empty() && toks[0]=="range"){
+                    if(toks.size() < 4){
+                        std::cerr << "sweep: range needs <start> <stop> <step> for " << ax.key << "\n";
+                        return false;
+                    }
+                    const double a = std::stod(toks[1]), b = std::stod(toks[2]), step = std::stod(toks[3]);
+                    if(step == 0.0 || (b-a)/step < 0.0){
+                        std::cerr << "sweep: bad range for " << ax.key << "\n";
+                        return false;
+                    }
+                    const long n = (long)std::floor((b-a)/step + 1e-9);
+                    for(long i=0;i<=n;i++) ax.values.push_back(a + (double)i*step);
+                }else{
+                    for(const auto& tok : toks) ax.values.push_back(std::stod(tok));
+                }
+            }catch(const std::exception&){
+                std::cerr << "sweep: bad value on vary line for " << ax.key << "\n";
+                return false;
+            }
+            if(ax.key.empty() || ax.values.empty()){
+                std::cerr << "sweep: empty vary line\n";
+                return false;
+            }
+            sp.axes.push_back(std::move(ax));
+        }
+    }
+    if(sp.base.empty()){
+        std::cerr << "sweep: missing base scenario\n";
+        return false;
+    }
+    return true;
+}
+
+// Mixed-radix decode of run index into one value per axis.
+static std::vector<double> variant_values(const SweepSpec& sp, size_t run){
+    std::vector<double> v(sp.axes.size());
+    for(size_t a=sp.axes.size(); a-- > 0;){
+        const size_t n = sp.axes[a].values.size();
+        v[a] = sp.axes[a].values[run % n];
+        run /= n;
+    }
+    return v;
+}
+
+static SweepResult run_variant(const ScenarioDef& base, const SweepSpec& sp, size_t run,
+                               const std::shared_ptr<const Ephemeris>& eph){
+    using clock = std::chrono::steady_clock;
+    SweepResult res;
+
+    // Copies cfg and entity blocks only; the catalog stays shared.
+    ScenarioDef def = base;
+    const auto vals = variant_values(sp, run);
+    for(size_t a=0;a<sp.axes.size();a++){
+        if(!apply_scenario_override(def, sp.axes[a].key, vals[a])) return res;
+    }
+
+    const auto t0 = clock::now();
+
+    PhysicsEngine e;
+    const ScenarioCfg cfg = build_scenario(def, e);
+    if(e.bodies.empty() || cfg.dt <= 0.0) return res;
+    if(cfg.epoch_jd != eph->epoch_jd() || cfg.t_end > eph->span_s()) return res;
+    if(!configure_engine(e, cfg, eph)) return res;
+
+    // Model reports go to run_<n>.log next to the CSV, or nowhere.
+    OutputWriter ow;
+    std::ofstream log;
+    if(!sp.output_dir.empty()){
+        const auto stem = std::filesystem::path(sp.output_dir) / ("run_" + std::to_string(run));
+        ow.open(stem.string() + ".csv", sp.output_rate);
+        log.open(stem.string() + ".log");
+    }
+    OutputWriter* ow_ptr = ow.enabled() ? &ow : nullptr;
+
+    // Same dispatch as --model; tle_hour only adds a report to the
+    // numeric run.
+    if(cfg.propagator == PROPAGATOR_SECULAR_J2){
+        run_secular_model(e, cfg.t_end, ow_ptr, log);
+    }else if(cfg.model == MODEL_ROCKET){
+        try{
+            run_rocket_model(e, cfg.dt, cfg.t_end, ow_ptr, nullptr, nullptr, log);
+        }catch(const std::exception&){
+            return res;
+        }
+        res.steps = (size_t)std::floor(cfg.t_end/cfg.dt) + 1;
+    }else{
+        double t = 0.0;
+        while(t < cfg.t_end){
+            e.step(cfg.dt);
+            t += cfg.dt;
+            res.steps++;
+            if(ow_ptr) ow.tick(t, e);
+        }
+    }
+
+    size_t idx = 0;
+    for(size_t i=0;i<e.names.size();i++){
+        if(e.names[i] == sp.report){ idx = i; break; }
+    }
+
+    res.coe = body_to_coe_eci(e.bodies[idx]);
+    res.n_bodies = e.bodies.size();
+    res.wall_ms = std::chrono::duration<double,std::milli>(clock::now() - t0).count();
+    res.ok = true;
+    return res;
+}
+
+bool run_sweep(const std::string& spec_path){
+    SweepSpec sp;
+    if(!parse_sweep_spec(spec_path, sp)) return false;
+
+    ScenarioDef base;
+    if(!parse_scenario(sp.base, base)) return false;
+
+    for(const auto& ax : sp.axes){
+        ScenarioDef probe = base;
+        if(!apply_scenario_override(probe, ax.key, ax.values.front())){
+            std::cerr << "sweep: unknown key " << ax.key << "\n";
+            return false;
+        }
+    }
+    if(!sp.report.empty()){
+        bool found = false;
+        for(const auto& en : base.ents) found = found || en.name == sp.report;
+        if(base.catalog)
+            for(const auto& n : base.catalog->names) found = found || n == sp.report;
+        if(!found){
+            std::cerr << "sweep: report entity " << sp.report << " is not in " << sp.base << "\n";
+            return false;
+        }
+    }
+    if(base.cfg.model == MODEL_LAMBERT_DEMO){
+        std::cerr << "sweep: the lambert_demo model has no per-run result to sweep\n";
+        return false;
+    }
+
+    size_t n_runs = 1;
+    for(const auto& ax : sp.axes) n_runs *= ax.values.size();
+
+    if(!sp.output_dir.empty()){
+        std::error_code ec;
+        std::filesystem::create_directories(sp.output_dir, ec);
+    }
+
+    // One ephemeris for every variant, covering the longest duration.
+    double span = base.cfg.t_end;
+    for(const auto& ax : sp.axes){
+        if(ax.key=="duration_seconds") span = std::max(span, *std::max_element(ax.values.begin(), ax.values.end()));
+    }
+    load_solar_system();
+    auto eph = std::make_shared<Ephemeris>();
+    eph->fit_analytic(base.cfg.epoch_jd, span + 86400.0);
+    const std::shared_ptr<const Ephemeris> shared_eph = eph;
+
+    std::vector<SweepResult> results(n_runs);
+    work_stealing_for(n_runs, sp.threads, [&](size_t run){
+        results[run] = run_variant(base, sp, run, shared_eph);
+    });
+
+    std::ofstream sf;
+    if(!sp.summary.empty()){
+        sf.open(sp.summary);
+        if(!sf){
+            std::cerr << "sweep: cannot write " << sp.summary << "\n";
+            return false;
+        }
+    }
+    std::ostream& out = sp.summary.empty() ? std::cout : sf;
+
+    out << "run";
+    for(const auto& ax : sp.axes) out << " " << ax.key;
+    out << " bodies steps wall_ms a_km e i_deg raan_deg argp_deg ta_deg\n";
+
+    size_t failed = 0;
+    for(size_t run=0;run<n_runs;run++){
+        const auto& r = results[run];
+        out << run;
+        for(double v : variant_values(sp, run)) out << " " << v;
+        if(!r.ok){
+            out << " failed\n";
+            failed++;
+            continue;
+        }
+        out << " " << r.n_bodies << " " << r.steps << " " << r.wall_ms
+            << " " << r.coe.a << " " << r.coe.e << " " << r.coe.i*RAD2DEG
+            << " " << r.coe.raan*RAD2DEG << " " << r.coe.argp*RAD2DEG << " " << r.coe.ta*RAD2DEG << "\n";
+    }
+
+    if(failed) std::cerr << "sweep: " << failed << " of " << n_runs << " runs failed\n";
+    return failed == 0;
+}
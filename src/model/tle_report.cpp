@@ -1,24 +1,31 @@
 #include "model/tle_report.hpp"
 #include "physics/engine.hpp"
 #include "core/geodesy.hpp"
+#include "core/frames.hpp"
 #include <iostream>
 #include <cmath>
 
 void run_tle_hour_report(PhysicsEngine& e,
                          const ScenarioCfg& cfg,
-                         OutputWriter* ow)
+                         OutputWriter* ow,
+                         Checkpointer* cp,
+                         const Checkpoint* resume)
 {
     // advance simulation normally
-    double t = 0.0;
+    double t = resume ? resume->t : 0.0;
     while(t < cfg.t_end){
         e.step(cfg.dt);
         t += cfg.dt;
         if(ow && ow->enabled())
             ow->tick(t, e);
+        if(cp && cp->due(t))
+            cp->submit(t, capture_checkpoint(e, t, cfg.dt, cfg.t_end, ow));
     }
 
-    // Washington DC (lat, lon, alt km)
-    auto dc = lla_to_ecef(38.9072, -77.0369, 0.0);
+    // Washington DC (lat, lon, alt km), Earth-fixed, rotated to ECI at t_end
+    const auto dc_ecef = lla_to_ecef(38.9072, -77.0369, 0.0);
+    double dc[3];
+    ecef_to_eci(gmst_rad(cfg.epoch_jd + cfg.t_end/86400.0), dc_ecef.data(), nullptr, dc, nullptr);
 
     std::cout << "\n--- Distance to Washington DC at t="
               << cfg.t_end << " ---\n";
@@ -1,7 +1,62 @@
 #include "physics/atmosphere.hpp"
+#include <algorithm>
 #include <cmath>
+
+// Base altitude (km), base density (kg/m^3), scale height (km).
+// Vallado, Fundamentals of Astrodynamics, Table 8-4.
+struct DensityBand{ double h0, rho0, H; };
+static constexpr DensityBand BANDS[] = {
+    {   0.0, 1.225,     7.249 }, {  25.0, 3.899e-2,  6.349 },
+    {  30.0, 1.774e-2,  6.682 }, {  40.0, 3.972e-3,  7.554 },
+    {  50.0, 1.057e-3,  8.382 }, {  60.0, 3.206e-4,  7.714 },
+    {  70.0, 8.770e-5,  6.549 }, {  80.0, 1.905e-5,  5.799 },
+    {  90.0, 3.396e-6,  5.382 }, { 100.0, 5.297e-7,  5.877 },
+    { 110.0, 9.661e-8,  7.263 }, { 120.0, 2.438e-8,  9.473 },
+    { 130.0, 8.484e-9, 12.636 }, { 140.0, 3.845e-9, 16.149 },
+    { 150.0, 2.070e-9, 22.523 }, { 180.0, 5.464e-10, 29.740 },
+    { 200.0, 2.789e-10, 37.105 }, { 250.0, 7.248e-11, 45.546 },
+    { 300.0, 2.418e-11, 53.628 }, { 350.0, 9.518e-12, 53.298 },
+    { 400.0, 3.725e-12, 58.515 }, { 450.0, 1.585e-12, 60.828 },
+    { 500.0, 6.967e-13, 63.822 }, { 600.0, 1.454e-13, 71.835 },
+    { 700.0, 3.614e-14, 88.667 }, { 800.0, 1.170e-14, 124.64 },
+    { 900.0, 5.245e-15, 181.05 }, {1000.0, 3.019e-15, 268.00 },
+};
+
+static constexpr int TABLE_KM = (int)ATMOSPHERE_TOP_KM;
+
+// rho at every whole km, 0..TABLE_KM.
+struct DensityTable{
+    double rho[TABLE_KM + 1];
+    DensityTable(){
+        size_t b = 0;
+        const size_t nb = sizeof(BANDS)/sizeof(BANDS[0]);
+        for(int h=0; h<=TABLE_KM; h++){
+            while(b+1 < nb && BANDS[b+1].h0 <= h) b++;
+            rho[h] = BANDS[b].rho0 * std::exp(-(h - BANDS[b].h0)/BANDS[b].H);
+        }
+    }
+};
+
+static const DensityTable& table(){
+    static const DensityTable t;
+    return t;
+}
+
+// Shared by the scalar and batch paths so both cut off at the same place:
+// zero from the top of the table up, selected rather than branched on.
+static inline double lookup(const double* rho, double h_km){
+    const double h = std::clamp(h_km, 0.0, ATMOSPHERE_TOP_KM);
+    const int i = std::min((int)h, TABLE_KM - 1);
+    const double f = h - i;
+    const double r = rho[i] + f*(rho[i+1] - rho[i]);
+    return h_km < ATMOSPHERE_TOP_KM ? r : 0.0;
+}
+
 double air_density(double h){
-    if(h<0) h=0;
-    if(h>100000) return 0.0;
-    return 1.225*exp(-h/8500.0);
+    return lookup(table().rho, h/1000.0);
+}
+
+void air_density_batch(size_t n, const double* alt_km, double* rho){
+    const double* t = table().rho;
+    for(size_t i=0;i<n;i++) rho[i] = lookup(t, alt_km[i]);
 }
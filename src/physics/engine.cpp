@@ -1,31 +1,182 @@
 #include "physics/engine.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/force_model.hpp"
+#include "physics/publish.hpp"
+#include "physics/atmosphere.hpp"
+#include "physics/shadow.hpp"
+#include "physics/sun.hpp"
+#include "core/environment.hpp"
+#include "core/geodesy.hpp"
 #include <cmath>
 #include <algorithm>
 
-static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
+static constexpr double G_KM3_KG_S2 = 6.67430e-20;  // km^3/(kg s^2)
+static constexpr double R_E_KM = 6378.137;          // drag altitude reference
+static constexpr double SRP_P_N_M2 = 4.56e-6;       // solar radiation pressure at 1 AU
+static constexpr double AU_KM = 149597870.7;
 
 void PhysicsEngine::add(const Body& b,const std::string& name){
     bodies.push_back(b);
     names.push_back(name);
 }
 
-void PhysicsEngine::step(double dt){
-    const size_t n=bodies.size();
-    if(n==0) return;
+bool PhysicsEngine::enable_third_body(const std::vector<std::string>& perturbers){
+    if(!ephemeris) return false;
+    const auto& env = Environment::instance();
+    third_bodies.clear();
+    for(const auto& nm : perturbers){
+        const int idx = ephemeris->index(nm);
+        if(idx < 0 || !env.has(nm)) return false;
+        third_bodies.push_back({idx, G_KM3_KG_S2 * env.get(nm).body.mass});
+    }
+    if(third_bodies.size() > ThirdBodyGravity::MAX_PERTURBERS) return false;
+    select_force_model();
+    return true;
+}
+
+bool PhysicsEngine::set_gravity(int degree,int order){
+    if(degree<=0) gravity = GravityField{};
+    else if(!make_earth_gravity(degree, order, gravity)) return false;
+    select_force_model();
+    return true;
+}
+
+// Batch term for the force pipeline: adds into the ax/ay/az scratch.
+// Zonal fields are axisymmetric and evaluated in ECI directly; tesseral
+// fields rotate positions into the Earth-fixed frame (GMST about z),
+// evaluate, and rotate the accelerations back.
+void PhysicsEngine::accumulate_harmonics(size_t n){
+    fx.resize(n); fy.resize(n); fz.resize(n);
+    if(gravity.zonal_only()){
+        for(size_t i=0;i<n;i++){ fx[i]=bodies[i].x; fy[i]=bodies[i].y; fz[i]=bodies[i].z; }
+        harmonics_accel_batch(gravity, n, fx.data(), fy.data(), fz.data(), ax.data(), ay.data(), az.data());
+        return;
+    }
 
+    const double th = gmst_rad(epoch_jd + time/86400.0);
+    const double c = std::cos(th), s = std::sin(th);
+    fax.assign(n, 0.0); fay.assign(n, 0.0); faz.assign(n, 0.0);
     for(size_t i=0;i<n;i++){
-        Body& b = bodies[i];
+        fx[i] =  c*bodies[i].x + s*bodies[i].y;
+        fy[i] = -s*bodies[i].x + c*bodies[i].y;
+        fz[i] =  bodies[i].z;
+    }
+    harmonics_accel_batch(gravity, n, fx.data(), fy.data(), fz.data(), fax.data(), fay.data(), faz.data());
+    for(size_t i=0;i<n;i++){
+        ax[i] += c*fax[i] - s*fay[i];
+        ay[i] += s*fax[i] + c*fay[i];
+        az[i] += faz[i];
+    }
+}
 
-        const double r2 = b.x*b.x + b.y*b.y + b.z*b.z;
-        const double r  = std::sqrt(std::max(1e-12, r2));
-        const double inv_r3 = 1.0/(r*r*r);
+void PhysicsEngine::set_drag(bool on){
+    drag = on;
+    drag_index.clear();
+    drag_bc.clear();
+    if(on){
+        const size_t n = std::min(bodies.size(), surfaces.size());
+        for(size_t i=0;i<n;i++){
+            if(surfaces[i].area_m2 > 0.0 && bodies[i].mass > 0.0){
+                drag_index.push_back((uint32_t)i);
+                drag_bc.push_back(surfaces[i].cd*surfaces[i].area_m2/bodies[i].mass);
+            }
+        }
+    }
+    drag_alt.resize(drag_index.size());
+    drag_rho.resize(drag_index.size());
+    select_force_model();
+}
+
+// Batch term: gathers the drag set's altitudes, looks densities up in one
+// pass, then scatters accelerations into the ax/ay/az scratch.
+void PhysicsEngine::accumulate_drag(){
+    const size_t m = drag_index.size();
+    const uint32_t* idx = drag_index.data();
+    for(size_t k=0;k<m;k++){
+        const Body& b = bodies[idx[k]];
+        drag_alt[k] = std::sqrt(b.x*b.x + b.y*b.y + b.z*b.z) - R_E_KM;
+    }
+    air_density_batch(m, drag_alt.data(), drag_rho.data());
+    for(size_t k=0;k<m;k++){
+        const uint32_t i = idx[k];
+        const Body& b = bodies[i];
+        drag_accel(drag_rho[k], drag_bc[k], b.x, b.y, b.vx, b.vy, b.vz, ax[i], ay[i], az[i]);
+    }
+}
 
-        const double ax = -MU_E_KM3_S2 * b.x * inv_r3;
-        const double ay = -MU_E_KM3_S2 * b.y * inv_r3;
-        const double az = -MU_E_KM3_S2 * b.z * inv_r3;
+void PhysicsEngine::set_srp(bool on){
+    srp = on;
+    srp_index.clear();
+    srp_k.clear();
+    if(on){
+        const size_t n = std::min(bodies.size(), surfaces.size());
+        for(size_t i=0;i<n;i++){
+            if(surfaces[i].area_m2 > 0.0 && bodies[i].mass > 0.0){
+                srp_index.push_back((uint32_t)i);
+                // N/m^2 * m^2/kg = m/s^2; 1e-3 to km/s^2
+                srp_k.push_back(1e-3*SRP_P_N_M2*surfaces[i].cr*surfaces[i].area_m2/bodies[i].mass);
+            }
+        }
+    }
+    srp_pos.resize(3*srp_index.size());
+    srp_nu.resize(srp_index.size());
+    srp_shadow.resize(srp_index.size());
+    select_force_model();
+}
 
-        // semi-implicit Euler
-        b.vx += ax*dt; b.vy += ay*dt; b.vz += az*dt;
-        b.x  += b.vx*dt; b.y  += b.vy*dt; b.z  += b.vz*dt;
+// Batch term: one Sun position per step, the SRP set's positions gathered
+// and classified by the shared shadow pass (penumbra gets the exact disc
+// overlap), then a = nu k (AU/d)^2 d_hat with d = r - r_sun.
+void PhysicsEngine::accumulate_srp(){
+    const auto s = sun_eci_km(epoch_jd + time/86400.0);
+    const double sun[3] = {s[0], s[1], s[2]};
+    const size_t m = srp_index.size();
+    const uint32_t* idx = srp_index.data();
+    double* p = srp_pos.data();
+    for(size_t k=0;k<m;k++){
+        const Body& b = bodies[idx[k]];
+        p[3*k] = b.x; p[3*k+1] = b.y; p[3*k+2] = b.z;
     }
+    shadow_batch(m, p, 3, sun, srp_shadow.data());
+    for(size_t k=0;k<m;k++){
+        const unsigned char st = srp_shadow[k];
+        srp_nu[k] = st == SHADOW_NONE ? 1.0
+                  : st == SHADOW_UMBRA ? 0.0
+                  : sunlight_fraction(p[3*k], p[3*k+1], p[3*k+2], sun);
+    }
+    for(size_t k=0;k<m;k++){
+        const uint32_t i = idx[k];
+        const double dx = p[3*k] - sun[0], dy = p[3*k+1] - sun[1], dz = p[3*k+2] - sun[2];
+        const double d2 = dx*dx + dy*dy + dz*dz;
+        const double f = srp_nu[k]*srp_k[k]*(AU_KM*AU_KM)/(d2*std::sqrt(d2));
+        ax[i] += f*dx;
+        ay[i] += f*dy;
+        az[i] += f*dz;
+    }
+}
+
+unsigned PhysicsEngine::force_features() const {
+    unsigned f = 0;
+    if(gravity.j2_only()) f |= FORCE_J2;
+    else if(gravity.degree >= 2) f |= FORCE_HARMONICS;
+    if(!third_bodies.empty() && ephemeris) f |= FORCE_THIRD_BODY;
+    if(drag && !drag_index.empty()) f |= FORCE_DRAG;
+    if(srp && !srp_index.empty()) f |= FORCE_SRP;
+    return f;
+}
+
+void PhysicsEngine::select_force_model(){
+    model = find_force_model(force_features());
+}
+
+bool PhysicsEngine::use_force_model(const ForceModel* m){
+    if(!m || m->features != force_features()) return false;
+    model = m;
+    return true;
+}
+
+void PhysicsEngine::step(double dt){
+    if(!model) model = find_force_model(force_features());
+    model->step(*this, dt);
+    if(publisher) publisher->publish(*this);
 }
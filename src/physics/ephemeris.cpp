@@ -0,0 +1,298 @@
+#include "physics/ephemeris.hpp"
+#include "physics/sun.hpp"
+#include "core/environment.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+static constexpr double AU_KM=149597870.7;
+static constexpr double DEG=M_PI/180.0;
+static constexpr double ARCSEC=DEG/3600.0;
+static constexpr double DAY_S=86400.0;
+static constexpr double J2000=2451545.0;
+static constexpr double EPS_J2000=23.43928*DEG;
+
+// Montenbruck & Gill low-precision lunar theory (ecliptic of date).
+std::array<double,3> moon_eci_km(double jd){
+    const double T=(jd-J2000)/36525.0;
+
+    const double L0=(218.31617 + 481267.88088*T - 1.3972*T)*DEG;
+    const double l =(134.96292 + 477198.86753*T)*DEG;
+    const double lp=(357.52543 +  35999.04944*T)*DEG;
+    const double F =( 93.27283 + 483202.01873*T)*DEG;
+    const double D =(297.85027 + 445267.11135*T)*DEG;
+
+    const double lon = L0 + ( 22640*sin(l) + 769*sin(2*l)
+        - 4586*sin(l-2*D) + 2370*sin(2*D) - 668*sin(lp) - 412*sin(2*F)
+        - 212*sin(2*l-2*D) - 206*sin(l+lp-2*D) + 192*sin(l+2*D)
+        - 165*sin(lp-2*D) + 148*sin(l-lp) - 125*sin(D) - 110*sin(l+lp)
+        - 55*sin(2*F-2*D) )*ARCSEC;
+
+    const double lat = ( 18520*sin(F + lon - L0 + (412*sin(2*F) + 541*sin(lp))*ARCSEC)
+        - 526*sin(F-2*D) + 44*sin(l+F-2*D) - 31*sin(-l+F-2*D)
+        - 25*sin(-2*l+F) - 23*sin(lp+F-2*D) + 21*sin(-l+F) + 11*sin(-lp+F-2*D) )*ARCSEC;
+
+    const double r = 385000.0 - 20905*cos(l) - 3699*cos(2*D-l) - 2956*cos(2*D)
+        - 570*cos(2*l) + 246*cos(2*l-2*D) - 205*cos(lp-2*D) - 171*cos(l+2*D)
+        - 152*cos(l+lp-2*D);
+
+    const double eps=(23.43929111 - 0.0130042*T)*DEG;
+    const double x = r*cos(lat)*cos(lon);
+    const double y = r*cos(lat)*sin(lon);
+    const double z = r*sin(lat);
+    return { x, cos(eps)*y - sin(eps)*z, sin(eps)*y + cos(eps)*z };
+}
+
+// Standish approximate Keplerian elements, J2000 ecliptic, valid 1800-2050.
+// a[AU] e I[deg] L[deg] varpi[deg] Omega[deg], then rates per Julian century.
+struct PlanetElems{ const char* name; double el[6]; double rate[6]; };
+static const PlanetElems PLANETS[] = {
+    {"Mars",    { 1.52371034, 0.09339410, 1.84969142,  -4.55343205, -23.94362959,  49.55953891},
+                { 0.00001847, 0.00007882,-0.00813131,19140.30268499,  0.44441088, -0.29257343}},
+    {"Jupiter", { 5.20288700, 0.04838624, 1.30439695,  34.39644051,  14.72847983, 100.47390909},
+                {-0.00011607,-0.00013253,-0.00183714, 3034.74612775,  0.21252668,  0.20469106}},
+    {"Saturn",  { 9.53667594, 0.05386179, 2.48599187,  49.95424423,  92.59887831, 113.66242448},
+                {-0.00125060,-0.00050991, 0.00193609, 1222.49362201, -0.41897216, -0.28867794}},
+    {"Uranus",  {19.18916464, 0.04725744, 0.77263783, 313.23810451, 170.95427630,  74.01692503},
+                {-0.00196176,-0.00004397,-0.00242939,  428.48202785,  0.40805281,   0.04240589}},
+    {"Neptune", {30.06992276, 0.00859048, 1.77004347, -55.12002969,  44.96476227, 131.78422574},
+                { 0.00026291, 0.00005105, 0.00035372,  218.45945325, -0.32241464,  -0.00508664}},
+    {"Pluto",   {39.48211675, 0.24882730,17.14001206, 238.92903833, 224.06891629, 110.30393684},
+                {-0.00031596, 0.00005170, 0.00004818,  145.20780515, -0.04062942,  -0.01183482}},
+};
+
+static std::array<double,3> planet_helio_eq_km(const PlanetElems& p,double jd){
+    const double T=(jd-J2000)/36525.0;
+    double el[6];
+    for(int k=0;k<6;k++) el[k]=p.el[k]+p.rate[k]*T;
+
+    const double a=el[0], e=el[1], I=el[2]*DEG;
+    const double varpi=el[4]*DEG, Om=el[5]*DEG;
+    const double w=varpi-Om;
+    const double M=std::remainder(el[3]*DEG-varpi, 2*M_PI);
+
+    double E=M + e*sin(M);
+    for(int i=0;i<8;i++) E -= (E - e*sin(E) - M)/(1.0 - e*cos(E));
+
+    const double xp=a*(cos(E)-e);
+    const double yp=a*std::sqrt(1.0-e*e)*sin(E);
+
+    const double cw=cos(w), sw=sin(w), cO=cos(Om), sO=sin(Om), cI=cos(I), sI=sin(I);
+    const double x=(cw*cO - sw*sO*cI)*xp + (-sw*cO - cw*sO*cI)*yp;
+    const double y=(cw*sO + sw*cO*cI)*xp + (-sw*sO + cw*cO*cI)*yp;
+    const double z=(sw*sI)*xp + (cw*sI)*yp;
+
+    const double ce=cos(EPS_J2000), se=sin(EPS_J2000);
+    return { x*AU_KM, (ce*y - se*z)*AU_KM, (se*y + ce*z)*AU_KM };
+}
+
+// Galilean moons: circular orbits in Jupiter's (~ecliptic) plane.
+// radius km, mean longitude at J2000 deg, rate deg/day (Meeus, low accuracy).
+struct MoonElems{ const char* name; double a_km; double u0_deg; double n_deg_day; };
+static const MoonElems GALILEAN[] = {
+    {"Io",       421700.0, 163.8069, 203.4058646},
+    {"Europa",   671034.0, 358.4140, 101.2916335},
+    {"Ganymede",1070412.0,   5.7176,  50.2345180},
+    {"Callisto",1882709.0, 224.8092,  21.4879800},
+};
+
+bool analytic_body_eci_km(const std::string& name,double jd,std::array<double,3>& out){
+    if(name=="Sun"){ out=sun_eci_km(jd); return true; }
+    if(name=="Moon"){ out=moon_eci_km(jd); return true; }
+
+    // geocentric = heliocentric + geocentric Sun
+    const auto sun=sun_eci_km(jd);
+    for(const auto& p : PLANETS){
+        if(name==p.name){
+            const auto h=planet_helio_eq_km(p,jd);
+            out={h[0]+sun[0], h[1]+sun[1], h[2]+sun[2]};
+            return true;
+        }
+    }
+    for(const auto& m : GALILEAN){
+        if(name==m.name){
+            std::array<double,3> jup;
+            analytic_body_eci_km("Jupiter",jd,jup);
+            const double u=(m.u0_deg + m.n_deg_day*(jd-J2000))*DEG;
+            const double ce=cos(EPS_J2000), se=sin(EPS_J2000);
+            const double x=m.a_km*cos(u), y=m.a_km*sin(u);
+            out={jup[0]+x, jup[1]+ce*y, jup[2]+se*y};
+            return true;
+        }
+    }
+    return false;
+}
+
+// Segment length (days) and coefficients per axis for each fitted body.
+struct FitPlan{ const char* name; double seg_days; int n; };
+static const FitPlan FIT_PLAN[] = {
+    {"Sun",      8.0,   12},
+    {"Moon",     1.0,   14},
+    {"Mars",     16.0,  12},
+    {"Jupiter",  16.0,  12},
+    {"Io",       0.125, 12},
+    {"Europa",   0.25,  12},
+    {"Ganymede", 0.5,   12},
+    {"Callisto", 1.0,   12},
+    {"Saturn",   16.0,  12},
+    {"Uranus",   16.0,  12},
+    {"Neptune",  16.0,  12},
+    {"Pluto",    16.0,  12},
+};
+
+// Chebyshev derivative series d_{k-1} = d_{k+1} + 2k c_k, scaled to per-second.
+static void derivative_series(const double* c,int n,double half_s,double* d){
+    std::vector<double> tmp((size_t)n+2, 0.0);
+    for(int k=n-1;k>=1;k--) tmp[(size_t)k-1]=tmp[(size_t)k+1]+2.0*k*c[k];
+    tmp[0]*=0.5;
+    for(int k=0;k<n;k++) d[k]=tmp[(size_t)k]/half_s;
+}
+
+void Ephemeris::fit_analytic(double jd_start,double span_s){
+    jd0=jd_start;
+    span=std::max(span_s, 1.0);
+    series.clear();
+
+    for(const auto& fp : FIT_PLAN){
+        Series s;
+        s.name=fp.name;
+        s.seg_s=fp.seg_days*DAY_S;
+        s.n=fp.n;
+        s.n_seg=(size_t)std::ceil(span/s.seg_s);
+        s.c.assign(s.n_seg*3*(size_t)s.n, 0.0);
+        s.dc.assign(s.c.size(), 0.0);
+
+        const int n=s.n;
+        std::vector<double> f(3*(size_t)n);
+        for(size_t seg=0;seg<s.n_seg;seg++){
+            const double half=0.5*s.seg_s;
+            const double mid=((double)seg+0.5)*s.seg_s;
+
+            // sample at Chebyshev-Gauss nodes
+            for(int j=0;j<n;j++){
+                const double xj=std::cos(M_PI*(j+0.5)/n);
+                std::array<double,3> p;
+                analytic_body_eci_km(s.name, jd0+(mid+half*xj)/DAY_S, p);
+                for(int a=0;a<3;a++) f[(size_t)a*n+j]=p[a];
+            }
+
+            for(int a=0;a<3;a++){
+                double* c=&s.c[(seg*3+a)*(size_t)n];
+                double* d=&s.dc[(seg*3+a)*(size_t)n];
+                for(int k=0;k<n;k++){
+                    double sum=0.0;
+                    for(int j=0;j<n;j++) sum+=f[(size_t)a*n+j]*std::cos(M_PI*k*(j+0.5)/n);
+                    c[k]=2.0*sum/n;
+                }
+                c[0]*=0.5;
+                derivative_series(c,n,half,d);
+            }
+        }
+        series.push_back(std::move(s));
+    }
+}
+
+int Ephemeris::index(const std::string& nm) const{
+    for(size_t i=0;i<series.size();i++) if(series[i].name==nm) return (int)i;
+    return -1;
+}
+
+const double* Ephemeris::segment(const Series& s,double t_s,double& x) const{
+    const double fs=std::floor(t_s/s.seg_s);
+    const size_t seg=(size_t)std::clamp(fs, 0.0, (double)(s.n_seg-1));
+    x=2.0*(t_s-(double)seg*s.seg_s)/s.seg_s - 1.0;
+    return &s.c[seg*3*(size_t)s.n];
+}
+
+static inline double clenshaw(const double* c,int n,double x){
+    double b1=0.0, b2=0.0;
+    const double x2=2.0*x;
+    for(int k=n-1;k>=1;k--){
+        const double b=x2*b1 - b2 + c[k];
+        b2=b1; b1=b;
+    }
+    return x*b1 - b2 + c[0];
+}
+
+std::array<double,3> Ephemeris::position(int body,double t_s) const{
+    const Series& s=series[(size_t)body];
+    double x;
+    const double* c=segment(s,t_s,x);
+    return { clenshaw(c,s.n,x), clenshaw(c+s.n,s.n,x), clenshaw(c+2*s.n,s.n,x) };
+}
+
+void Ephemeris::state(int body,double t_s,double r[3],double v[3]) const{
+    const Series& s=series[(size_t)body];
+    double x;
+    const double* c=segment(s,t_s,x);
+    const double* d=s.dc.data() + (size_t)(c - s.c.data());
+    for(int a=0;a<3;a++){
+        r[a]=clenshaw(c+a*s.n,s.n,x);
+        v[a]=clenshaw(d+a*s.n,s.n,x);
+    }
+}
+
+bool Ephemeris::save(const std::string& path) const{
+    std::ofstream out(path);
+    if(!out) return false;
+    out << std::setprecision(17);
+    out << "# spacesim2 chebyshev ephemeris (km, seconds since epoch)\n";
+    out << "epoch_jd " << jd0 << "\n";
+    out << "span_s " << span << "\n";
+    for(const auto& s : series){
+        out << "body " << s.name << " seg_s " << s.seg_s << " n " << s.n << " segments " << s.n_seg << "\n";
+        for(size_t row=0;row<s.n_seg*3;row++){
+            for(int k=0;k<s.n;k++) out << (k ? " " : "") << s.c[row*(size_t)s.n+(size_t)k];
+            out << "\n";
+        }
+    }
+    return (bool)out;
+}
+
+bool Ephemeris::load(const std::string& path){
+    std::ifstream f(path);
+    if(!f) return false;
+
+    Ephemeris eph;
+    std::string line;
+    while(std::getline(f,line)){
+        std::istringstream ss(line);
+        std::string k;
+        ss >> k;
+        if(k.empty() || k[0]=='#') continue;
+        if(k=="epoch_jd"){ ss >> eph.jd0; }
+        else if(k=="span_s"){ ss >> eph.span; }
+        else if(k=="body"){
+            Series s;
+            std::string kw;
+            ss >> s.name >> kw >> s.seg_s >> kw >> s.n >> kw >> s.n_seg;
+            if(!ss || s.n<=0 || s.n_seg==0 || s.seg_s<=0.0) return false;
+            s.c.resize(s.n_seg*3*(size_t)s.n);
+            for(auto& v : s.c) if(!(f >> v)) return false;
+
+            s.dc.assign(s.c.size(), 0.0);
+            for(size_t row=0;row<s.n_seg*3;row++){
+                derivative_series(&s.c[row*(size_t)s.n], s.n, 0.5*s.seg_s, &s.dc[row*(size_t)s.n]);
+            }
+            eph.series.push_back(std::move(s));
+        }
+    }
+    if(eph.series.empty()) return false;
+    *this=std::move(eph);
+    return true;
+}
+
+void refresh_environment(const Ephemeris& eph,double t_s){
+    auto& env=Environment::instance();
+    for(size_t i=0;i<eph.size();i++){
+        if(!env.has(eph.name(i))) continue;
+        double r[3], v[3];
+        eph.state((int)i, t_s, r, v);
+        Body b=env.get(eph.name(i)).body;
+        b.x=r[0]; b.y=r[1]; b.z=r[2];
+        b.vx=v[0]; b.vy=v[1]; b.vz=v[2];
+        env.set_body(eph.name(i), b);
+    }
+}
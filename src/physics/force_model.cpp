@@ -0,0 +1,62 @@
+#include "physics/force_model.hpp"
+
+using PipeTwoBody           = ForcePipeline<SemiImplicitEuler, CentralGravity>;
+using PipeJ2                = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity>;
+using PipeField             = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity>;
+using PipeThird             = ForcePipeline<SemiImplicitEuler, CentralGravity, ThirdBodyGravity>;
+using PipeThirdJ2           = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, ThirdBodyGravity>;
+using PipeThirdField        = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, ThirdBodyGravity>;
+using PipeDrag              = ForcePipeline<SemiImplicitEuler, CentralGravity, DragForce>;
+using PipeJ2Drag            = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, DragForce>;
+using PipeFieldDrag         = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, DragForce>;
+using PipeThirdDrag         = ForcePipeline<SemiImplicitEuler, CentralGravity, ThirdBodyGravity, DragForce>;
+using PipeThirdJ2Drag       = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, ThirdBodyGravity, DragForce>;
+using PipeThirdFieldDrag    = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, ThirdBodyGravity, DragForce>;
+using PipeSrp               = ForcePipeline<SemiImplicitEuler, CentralGravity, SrpForce>;
+using PipeJ2Srp             = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, SrpForce>;
+using PipeFieldSrp          = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, SrpForce>;
+using PipeThirdSrp          = ForcePipeline<SemiImplicitEuler, CentralGravity, ThirdBodyGravity, SrpForce>;
+using PipeThirdJ2Srp        = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, ThirdBodyGravity, SrpForce>;
+using PipeThirdFieldSrp     = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, ThirdBodyGravity, SrpForce>;
+using PipeDragSrp           = ForcePipeline<SemiImplicitEuler, CentralGravity, DragForce, SrpForce>;
+using PipeJ2DragSrp         = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, DragForce, SrpForce>;
+using PipeFieldDragSrp      = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, DragForce, SrpForce>;
+using PipeThirdDragSrp      = ForcePipeline<SemiImplicitEuler, CentralGravity, ThirdBodyGravity, DragForce, SrpForce>;
+using PipeThirdJ2DragSrp    = ForcePipeline<SemiImplicitEuler, CentralGravity, J2Gravity, ThirdBodyGravity, DragForce, SrpForce>;
+using PipeThirdFieldDragSrp = ForcePipeline<SemiImplicitEuler, CentralGravity, HarmonicsGravity, ThirdBodyGravity, DragForce, SrpForce>;
+
+const std::vector<ForceModel>& force_models(){
+    static const std::vector<ForceModel> models = {
+        {"two_body",             0,                                 &PipeTwoBody::step},
+        {"j2",                   FORCE_J2,                          &PipeJ2::step},
+        {"harmonics",            FORCE_HARMONICS,                   &PipeField::step},
+        {"third_body",           FORCE_THIRD_BODY,                  &PipeThird::step},
+        {"j2+third_body",        FORCE_J2|FORCE_THIRD_BODY,         &PipeThirdJ2::step},
+        {"harmonics+third_body", FORCE_HARMONICS|FORCE_THIRD_BODY,  &PipeThirdField::step},
+        {"drag",                 FORCE_DRAG,                        &PipeDrag::step},
+        {"j2+drag",              FORCE_J2|FORCE_DRAG,               &PipeJ2Drag::step},
+        {"harmonics+drag",       FORCE_HARMONICS|FORCE_DRAG,        &PipeFieldDrag::step},
+        {"third_body+drag",      FORCE_THIRD_BODY|FORCE_DRAG,       &PipeThirdDrag::step},
+        {"j2+third_body+drag",   FORCE_J2|FORCE_THIRD_BODY|FORCE_DRAG, &PipeThirdJ2Drag::step},
+        {"harmonics+third_body+drag", FORCE_HARMONICS|FORCE_THIRD_BODY|FORCE_DRAG, &PipeThirdFieldDrag::step},
+        {"srp",                  FORCE_SRP,                         &PipeSrp::step},
+        {"j2+srp",               FORCE_J2|FORCE_SRP,                &PipeJ2Srp::step},
+        {"harmonics+srp",        FORCE_HARMONICS|FORCE_SRP,         &PipeFieldSrp::step},
+        {"third_body+srp",       FORCE_THIRD_BODY|FORCE_SRP,        &PipeThirdSrp::step},
+        {"j2+third_body+srp",    FORCE_J2|FORCE_THIRD_BODY|FORCE_SRP, &PipeThirdJ2Srp::step},
+        {"harmonics+third_body+srp", FORCE_HARMONICS|FORCE_THIRD_BODY|FORCE_SRP, &PipeThirdFieldSrp::step},
+        {"drag+srp",             FORCE_DRAG|FORCE_SRP,              &PipeDragSrp::step},
+        {"j2+drag+srp",          FORCE_J2|FORCE_DRAG|FORCE_SRP,     &PipeJ2DragSrp::step},
+        {"harmonics+drag+srp",   FORCE_HARMONICS|FORCE_DRAG|FORCE_SRP, &PipeFieldDragSrp::step},
+        {"third_body+drag+srp",  FORCE_THIRD_BODY|FORCE_DRAG|FORCE_SRP, &PipeThirdDragSrp::step},
+        {"j2+third_body+drag+srp", FORCE_J2|FORCE_THIRD_BODY|FORCE_DRAG|FORCE_SRP, &PipeThirdJ2DragSrp::step},
+        {"harmonics+third_body+drag+srp", FORCE_HARMONICS|FORCE_THIRD_BODY|FORCE_DRAG|FORCE_SRP, &PipeThirdFieldDragSrp::step},
+    };
+    return models;
+}
+
+const ForceModel* find_force_model(unsigned features){
+    for(const auto& m : force_models())
+        if(m.features == features) return &m;
+    return nullptr;
+}
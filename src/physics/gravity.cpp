@@ -0,0 +1,154 @@
+#include "physics/gravity.hpp"
+#include <algorithm>
+#include <cmath>
+
+// EGM96 fully normalized coefficients, n=2..6.
+struct NormCoef{ int n,m; double C,S; };
+static const NormCoef EGM96[] = {
+    {2,0,-4.84165371736e-4, 0.0},
+    {2,1,-1.86987635955e-10, 1.19528012031e-9},
+    {2,2, 2.43914352398e-6,-1.40016683654e-6},
+    {3,0, 9.57254173792e-7, 0.0},
+    {3,1, 2.02998882184e-6, 2.48513158716e-7},
+    {3,2, 9.04627768605e-7,-6.19025944205e-7},
+    {3,3, 7.21072657057e-7, 1.41435626958e-6},
+    {4,0, 5.39873863789e-7, 0.0},
+    {4,1,-5.36321616971e-7,-4.73440265853e-7},
+    {4,2, 3.50694105785e-7, 6.62671572540e-7},
+    {4,3, 9.90771803829e-7,-2.00928369177e-7},
+    {4,4,-1.88560802735e-7, 3.08853169333e-7},
+    {5,0, 6.86702913736e-8, 0.0},
+    {5,1,-6.29211923042e-8,-9.43698073395e-8},
+    {5,2, 6.52078043176e-7,-3.23353192540e-7},
+    {5,3,-4.51847152328e-7,-2.14955408306e-7},
+    {5,4,-2.95328761175e-7, 4.98070550102e-8},
+    {5,5, 1.74811795496e-7,-6.69379935180e-7},
+    {6,0,-1.49957994714e-7, 0.0},
+    {6,1,-7.59525591713e-8, 2.65122593213e-8},
+    {6,2, 4.86488426727e-8,-3.73789324523e-7},
+    {6,3, 5.72451611175e-8, 8.95201130910e-9},
+    {6,4,-8.60237937534e-8,-4.71425180854e-7},
+    {6,5,-2.67101275370e-7,-5.36493164169e-7},
+    {6,6, 9.47068098579e-9,-2.37382353351e-7},
+};
+
+static double factorial(int k){
+    double f=1.0;
+    for(int i=2;i<=k;i++) f*=i;
+    return f;
+}
+
+bool make_earth_gravity(int degree,int order,GravityField& g){
+    if(degree<2 || degree>GRAVITY_MAX_DEGREE || order<0 || order>degree) return false;
+    g = GravityField{};
+    g.degree=degree;
+    g.order=order;
+    const size_t tri=(size_t)((degree+1)*(degree+2)/2);
+    g.C.assign(tri,0.0);
+    g.S.assign(tri,0.0);
+    for(const auto& k : EGM96){
+        if(k.n>degree || k.m>order) continue;
+        const double N=std::sqrt((k.m==0 ? 1.0 : 2.0)*(2*k.n+1)*factorial(k.n-k.m)/factorial(k.n+k.m));
+        g.C[(size_t)(k.n*(k.n+1)/2+k.m)]=N*k.C;
+        g.S[(size_t)(k.n*(k.n+1)/2+k.m)]=N*k.S;
+    }
+    return true;
+}
+
+static constexpr size_t LANES = 8;
+static constexpr int VW_MAX = GRAVITY_MAX_DEGREE + 1;
+static constexpr size_t VW_TRI = (size_t)((VW_MAX+1)*(VW_MAX+2)/2);
+
+static inline size_t tri(int n,int m){ return (size_t)(n*(n+1)/2+m); }
+
+// Montenbruck & Gill 3.2.4: V_nm/W_nm recursion to degree N+1, then
+// accumulate accelerations for 2<=n<=N, m<=M. Every loop body runs over
+// LANES independent bodies.
+static void harmonics_block(const GravityField& g,size_t cnt,
+                            const double* x,const double* y,const double* z,
+                            double* ax,double* ay,double* az)
+{
+    const int N=g.degree, M=g.order;
+    const double R=g.re_km;
+
+    alignas(64) double V[VW_TRI][LANES];
+    alignas(64) double W[VW_TRI][LANES];
+    alignas(64) double xr[LANES], yr[LANES], zr[LANES], rr[LANES];
+
+    for(size_t l=0;l<LANES;l++){
+        const size_t i = l<cnt ? l : 0;           // pad with a valid body
+        const double r2=x[i]*x[i]+y[i]*y[i]+z[i]*z[i];
+        const double k=R/r2;
+        xr[l]=x[i]*k; yr[l]=y[i]*k; zr[l]=z[i]*k; rr[l]=R*k;
+        V[0][l]=R/std::sqrt(r2);
+        W[0][l]=0.0;
+    }
+
+    for(int m=0;m<=M+1;m++){
+        if(m>0){
+            const double f=2*m-1;
+            const size_t d=tri(m,m), p=tri(m-1,m-1);
+            for(size_t l=0;l<LANES;l++){
+                V[d][l]=f*(xr[l]*V[p][l]-yr[l]*W[p][l]);
+                W[d][l]=f*(xr[l]*W[p][l]+yr[l]*V[p][l]);
+            }
+        }
+        for(int n=m+1;n<=N+1;n++){
+            const double a=(double)(2*n-1)/(n-m);
+            const double b=(double)(n+m-1)/(n-m);
+            const size_t d=tri(n,m), p1=tri(n-1,m);
+            if(n==m+1){
+                for(size_t l=0;l<LANES;l++){
+                    V[d][l]=a*zr[l]*V[p1][l];
+                    W[d][l]=a*zr[l]*W[p1][l];
+                }
+            }else{
+                const size_t p2=tri(n-2,m);
+                for(size_t l=0;l<LANES;l++){
+                    V[d][l]=a*zr[l]*V[p1][l]-b*rr[l]*V[p2][l];
+                    W[d][l]=a*zr[l]*W[p1][l]-b*rr[l]*W[p2][l];
+                }
+            }
+        }
+    }
+
+    alignas(64) double sx[LANES]={}, sy[LANES]={}, sz[LANES]={};
+    for(int n=2;n<=N;n++){
+        for(int m=0;m<=std::min(n,M);m++){
+            const double C=g.c(n,m), S=g.s(n,m);
+            if(m==0){
+                const size_t u=tri(n+1,1), v=tri(n+1,0);
+                for(size_t l=0;l<LANES;l++){
+                    sx[l]+=-C*V[u][l];
+                    sy[l]+=-C*W[u][l];
+                    sz[l]+=(n+1)*(-C*V[v][l]);
+                }
+            }else{
+                const double fac=factorial(n-m+2)/factorial(n-m);
+                const size_t up=tri(n+1,m+1), dn=tri(n+1,m-1), same=tri(n+1,m);
+                for(size_t l=0;l<LANES;l++){
+                    sx[l]+=0.5*((-C*V[up][l]-S*W[up][l]) + fac*( C*V[dn][l]+S*W[dn][l]));
+                    sy[l]+=0.5*((-C*W[up][l]+S*V[up][l]) + fac*(-C*W[dn][l]+S*V[dn][l]));
+                    sz[l]+=(n-m+1)*(-C*V[same][l]-S*W[same][l]);
+                }
+            }
+        }
+    }
+
+    const double k=g.mu_km3_s2/(R*R);
+    for(size_t l=0;l<cnt;l++){
+        ax[l]+=k*sx[l];
+        ay[l]+=k*sy[l];
+        az[l]+=k*sz[l];
+    }
+}
+
+void harmonics_accel_batch(const GravityField& g,size_t n,
+                           const double* x,const double* y,const double* z,
+                           double* ax,double* ay,double* az)
+{
+    for(size_t i=0;i<n;i+=LANES){
+        const size_t cnt = (n-i<LANES) ? n-i : LANES;
+        harmonics_block(g,cnt,x+i,y+i,z+i,ax+i,ay+i,az+i);
+    }
+}
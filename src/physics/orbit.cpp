@@ -94,3 +94,18 @@ COE body_to_coe_eci(const Body& b){
     c.a=a; c.e=e; c.i=i; c.raan=raan; c.argp=argp; c.ta=ta;
     return c;
 }
+
+double true_from_mean(double M, double e){
+    double E = M + e*std::sin(M);
+    for(int it=0; it<15; it++){
+        const double d = (E - e*std::sin(E) - M)/(1.0 - e*std::cos(E));
+        E -= d;
+        if(std::fabs(d) < 1e-13) break;
+    }
+    return 2.0*std::atan2(std::sqrt(1.0+e)*std::sin(0.5*E), std::sqrt(1.0-e)*std::cos(0.5*E));
+}
+
+double mean_from_true(double ta, double e){
+    const double E = 2.0*std::atan2(std::sqrt(1.0-e)*std::sin(0.5*ta), std::sqrt(1.0+e)*std::cos(0.5*ta));
+    return E - e*std::sin(E);
+}
@@ -0,0 +1,25 @@
+#include "physics/publish.hpp"
+
+size_t StatePublisher::add_reader(){
+    readers.push_back(std::make_unique<TripleBuffer<StateSnapshot>>());
+    return readers.size() - 1;
+}
+
+void StatePublisher::publish(const PhysicsEngine& e){
+    seq++;
+    for(auto& r : readers){
+        StateSnapshot& s = r->back();
+        s.seq = seq;
+        s.time = e.time;
+        s.epoch_jd = e.epoch_jd;
+        s.bodies.assign(e.bodies.begin(), e.bodies.end());
+        if(s.names.size() != e.names.size()) s.names = e.names;
+        r->publish();
+    }
+}
+
+const StateSnapshot& StatePublisher::latest(size_t id){
+    TripleBuffer<StateSnapshot>& r = *readers[id];
+    r.update();
+    return r.front();
+}
@@ -1,4 +1,5 @@
 #include "physics/rocket.hpp"
+#include "physics/atmosphere.hpp"
 #include <cmath>
 #include <algorithm>
 
@@ -45,6 +46,12 @@ void Rocket::step(double dt_s, double mu_km3_s2,
     double ay = -mu_km3_s2 * y / (r*r*r);
     double az = -mu_km3_s2 * z / (r*r*r);
 
+    // drag against the co-rotating atmosphere
+    if(aero_area_m2 > 0.0 && mass > 1e-9){
+        const double rho = air_density((r - R_E_KM)*1000.0);
+        if(rho > 0.0) drag_accel(rho, aero_cd*aero_area_m2/mass, x,y, vx,vy,vz, ax,ay,az);
+    }
+
     if(cur < st.size() && fuel > 0.0 && mass > 1e-9){
         powered=true;
 
@@ -126,3 +133,20 @@ void Rocket::force_cutoff(){
     fuel=0.0;
     dry=mass; // whatever is left
 }
+
+RocketCheckpoint Rocket::checkpoint() const{
+    RocketCheckpoint c;
+    c.stages=st; c.cur=cur;
+    c.fuel=fuel; c.dry=dry; c.mass=mass;
+    c.s=state();
+    c.sep=sep; c.powered=powered; c.is_dead=is_dead;
+    return c;
+}
+
+void Rocket::restore(const RocketCheckpoint& c){
+    st=c.stages; cur=c.cur;
+    fuel=c.fuel; dry=c.dry;
+    set_state(c.s);
+    mass=c.mass;
+    sep=c.sep; powered=c.powered; is_dead=c.is_dead;
+}
@@ -0,0 +1,183 @@
+#include "physics/secular.hpp"
+#include <cmath>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
+static constexpr double R_E_KM = 6378.137;
+static constexpr double J2 = 1.08262668e-3;
+static constexpr double TWO_PI = 2.0*M_PI;
+static constexpr int KEPLER_MAX_ITERS = 15;
+
+void j2_secular_rates(double a, double e, double i,
+                      double& raan_dot, double& argp_dot, double& M_dot){
+    const double n = std::sqrt(MU_E_KM3_S2/(a*a*a));
+    const double p = a*(1.0 - e*e);
+    const double k = 1.5*n*J2*(R_E_KM/p)*(R_E_KM/p);
+    const double c = std::cos(i);
+    raan_dot = -k*c;
+    argp_dot = 0.5*k*(5.0*c*c - 1.0);
+    M_dot = n + 0.5*k*std::sqrt(1.0 - e*e)*(3.0*c*c - 1.0);
+}
+
+static double solve_kepler(double M, double e){
+    double E = M + e*std::sin(M);
+    for(int it=0; it<KEPLER_MAX_ITERS; it++){
+        const double d = (E - e*std::sin(E) - M)/(1.0 - e*std::cos(E));
+        E -= d;
+        if(std::fabs(d) < 1e-13) break;
+    }
+    return E;
+}
+
+void SecularCatalog::reserve(size_t n){
+    for(auto* v : {&a, &e, &inc, &raan0, &argp0, &M0, &raan_dot, &argp_dot, &M_dot,
+                   &sq1me2, &sqrt_mu_a, &ci, &si, &mass}) v->reserve(n);
+}
+
+void SecularCatalog::add(const COE& c, double m, double t_epoch){
+    double rd, wd, md;
+    j2_secular_rates(c.a, c.e, c.i, rd, wd, md);
+    // stored angles are referred back to t=0
+    a.push_back(c.a);
+    e.push_back(c.e);
+    inc.push_back(c.i);
+    raan0.push_back(std::fmod(c.raan - rd*t_epoch, TWO_PI));
+    argp0.push_back(std::fmod(c.argp - wd*t_epoch, TWO_PI));
+    M0.push_back(std::fmod(mean_from_true(c.ta, c.e) - md*t_epoch, TWO_PI));
+    raan_dot.push_back(rd);
+    argp_dot.push_back(wd);
+    M_dot.push_back(md);
+    sq1me2.push_back(std::sqrt(1.0 - c.e*c.e));
+    sqrt_mu_a.push_back(std::sqrt(MU_E_KM3_S2*c.a));
+    ci.push_back(std::cos(c.i));
+    si.push_back(std::sin(c.i));
+    mass.push_back(m);
+}
+
+// Like body_to_coe_eci, but circular and equatorial orbits keep their phase:
+// the anomaly is measured from the node (or +x) via the argument of latitude.
+void SecularCatalog::add(const Body& b){
+    const double rx=b.x, ry=b.y, rz=b.z, vx=b.vx, vy=b.vy, vz=b.vz;
+    const double r = std::sqrt(rx*rx + ry*ry + rz*rz);
+    const double v2 = vx*vx + vy*vy + vz*vz;
+    const double rv = rx*vx + ry*vy + rz*vz;
+
+    const double hx = ry*vz - rz*vy, hy = rz*vx - rx*vz, hz = rx*vy - ry*vx;
+    const double h = std::sqrt(hx*hx + hy*hy + hz*hz);
+    const double hxy = std::sqrt(hx*hx + hy*hy);
+
+    COE c{};
+    c.a = 1.0/(2.0/r - v2/MU_E_KM3_S2);
+    c.i = std::atan2(hxy, hz);
+
+    // node direction n, and m = h_hat x n completing the in-plane basis
+    double nx = 1.0, ny = 0.0;
+    if(hxy > 1e-12*h){ nx = -hy/hxy; ny = hx/hxy; c.raan = std::atan2(ny, nx); }
+    const double mx = -hz*ny/h, my = hz*nx/h, mz = (hx*ny - hy*nx)/h;
+
+    const double ex = ((v2 - MU_E_KM3_S2/r)*rx - rv*vx)/MU_E_KM3_S2;
+    const double ey = ((v2 - MU_E_KM3_S2/r)*ry - rv*vy)/MU_E_KM3_S2;
+    const double ez = ((v2 - MU_E_KM3_S2/r)*rz - rv*vz)/MU_E_KM3_S2;
+    c.e = std::sqrt(ex*ex + ey*ey + ez*ez);
+
+    const double u = std::atan2(rx*mx + ry*my + rz*mz, rx*nx + ry*ny);
+    if(c.e > 1e-10) c.argp = std::atan2(ex*mx + ey*my + ez*mz, ex*nx + ey*ny);
+    else c.e = 0.0;
+    c.ta = u - c.argp;
+    if(c.raan < 0.0) c.raan += TWO_PI;
+    if(c.argp < 0.0) c.argp += TWO_PI;
+    if(c.ta < 0.0) c.ta += TWO_PI;
+    add(c, b.mass);
+}
+
+COE SecularCatalog::elements_at(size_t k, double t) const {
+    const double E = solve_kepler(std::fmod(M0[k] + M_dot[k]*t, TWO_PI), e[k]);
+    COE c{};
+    c.a = a[k]; c.e = e[k]; c.i = inc[k];
+    c.raan = std::fmod(raan0[k] + raan_dot[k]*t, TWO_PI);
+    c.argp = std::fmod(argp0[k] + argp_dot[k]*t, TWO_PI);
+    c.ta = 2.0*std::atan2(std::sqrt(1.0+e[k])*std::sin(0.5*E), std::sqrt(1.0-e[k])*std::cos(0.5*E));
+    return c;
+}
+
+void SecularCatalog::state_at(size_t k, double t, Body& b) const {
+    const double ek = e[k];
+    const double E = solve_kepler(std::fmod(M0[k] + M_dot[k]*t, TWO_PI), ek);
+    const double cE = std::cos(E), sE = std::sin(E);
+
+    // perifocal state
+    const double xp = a[k]*(cE - ek);
+    const double yp = a[k]*sq1me2[k]*sE;
+    const double f  = sqrt_mu_a[k]/(a[k]*(1.0 - ek*cE));
+    const double vxp = -f*sE;
+    const double vyp =  f*sq1me2[k]*cE;
+
+    const double O = raan0[k] + raan_dot[k]*t;
+    const double w = argp0[k] + argp_dot[k]*t;
+    const double cO = std::cos(O), sO = std::sin(O);
+    const double cw = std::cos(w), sw = std::sin(w);
+    const double cI = ci[k], sI = si[k];
+
+    // columns P, Q of R3(O) R1(i) R3(w)
+    const double Px = cO*cw - sO*sw*cI, Py = sO*cw + cO*sw*cI, Pz = sw*sI;
+    const double Qx = -cO*sw - sO*cw*cI, Qy = -sO*sw + cO*cw*cI, Qz = cw*sI;
+
+    b.x  = xp*Px + yp*Qx;  b.y  = xp*Py + yp*Qy;  b.z  = xp*Pz + yp*Qz;
+    b.vx = vxp*Px + vyp*Qx; b.vy = vxp*Py + vyp*Qy; b.vz = vxp*Pz + vyp*Qz;
+    b.mass = mass[k];
+}
+
+void SecularCatalog::states_on_grid(size_t k, double t0, double dt, size_t m, Body* out) const {
+    if(m == 0) return;
+    const double ek = e[k], ak = a[k];
+    const double dM = M_dot[k]*dt;
+    const double dO = raan_dot[k]*dt, dw = argp_dot[k]*dt;
+    const double cdO = std::cos(dO), sdO = std::sin(dO);
+    const double cdw = std::cos(dw), sdw = std::sin(dw);
+    const double O0 = raan0[k] + raan_dot[k]*t0, w0 = argp0[k] + argp_dot[k]*t0;
+    double cO = std::cos(O0), sO = std::sin(O0);
+    double cw = std::cos(w0), sw = std::sin(w0);
+    const double cI = ci[k], sI = si[k];
+
+    double M = std::fmod(M0[k] + M_dot[k]*t0, TWO_PI);
+    double E = solve_kepler(M, ek);
+    double cE = std::cos(E), sE = std::sin(E);
+    for(size_t i=0;i<m;i++){
+        if(i > 0){
+            M += dM;
+            // first-order predictor, then Newton to the solve_kepler tolerance
+            E += dM/(1.0 - ek*cE);
+            for(int it=0; it<KEPLER_MAX_ITERS; it++){
+                cE = std::cos(E); sE = std::sin(E);
+                const double d = (E - ek*sE - M)/(1.0 - ek*cE);
+                E -= d;
+                // carry cE, sE through the step to first order; exact enough
+                // once |d| < 1e-9 (quadratic convergence), else re-evaluated
+                const double c1 = cE + d*sE;
+                sE -= d*cE; cE = c1;
+                if(std::fabs(d) < 1e-9) break;
+            }
+            const double cO1 = cO*cdO - sO*sdO, sO1 = sO*cdO + cO*sdO;
+            const double cw1 = cw*cdw - sw*sdw, sw1 = sw*cdw + cw*sdw;
+            cO = cO1; sO = sO1; cw = cw1; sw = sw1;
+        }
+
+        const double xp = ak*(cE - ek);
+        const double yp = ak*sq1me2[k]*sE;
+        const double f  = sqrt_mu_a[k]/(ak*(1.0 - ek*cE));
+        const double vxp = -f*sE;
+        const double vyp =  f*sq1me2[k]*cE;
+
+        const double Px = cO*cw - sO*sw*cI, Py = sO*cw + cO*sw*cI, Pz = sw*sI;
+        const double Qx = -cO*sw - sO*cw*cI, Qy = -sO*sw + cO*cw*cI, Qz = cw*sI;
+
+        Body& b = out[i];
+        b.x  = xp*Px + yp*Qx;  b.y  = xp*Py + yp*Qy;  b.z  = xp*Pz + yp*Qz;
+        b.vx = vxp*Px + vyp*Qx; b.vy = vxp*Py + vyp*Qy; b.vz = vxp*Pz + vyp*Qz;
+        b.mass = mass[k];
+    }
+}
+
+void SecularCatalog::states_at(double t, Body* out) const {
+    const size_t n = size();
+    for(size_t k=0;k<n;k++) state_at(k, t, out[k]);
+}
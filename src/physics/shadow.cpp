@@ -0,0 +1,32 @@
+#include "physics/shadow.hpp"
+
+// Penumbra half-angle (R_sun + R_E)/|sun| is ~0.0047 over the year; the
+// pre-test cone is opened 10% wider, plus a fixed km of slack.
+static constexpr double PRETEST_SLOPE_MARGIN = 1.1;
+static constexpr double PRETEST_SLACK_KM = 1.0;
+
+size_t shadow_batch(size_t n, const double* xyz, size_t stride, const double sun[3],
+                  unsigned char* state){
+    const double s = std::sqrt(sun[0]*sun[0] + sun[1]*sun[1] + sun[2]*sun[2]);
+    const double ux = sun[0]/s, uy = sun[1]/s, uz = sun[2]/s;
+    const double slope = PRETEST_SLOPE_MARGIN*(SHADOW_R_SUN_KM + SHADOW_R_EARTH_KM)/s;
+
+    // Pass 1: within R_E - slope * d of the shadow axis, d = r . sun_hat
+    // (the penumbra cone, widened; it closes on the sunward side).
+    for(size_t i=0;i<n;i++){
+        const double* r = xyz + i*stride;
+        const double d = r[0]*ux + r[1]*uy + r[2]*uz;
+        const double r2 = r[0]*r[0] + r[1]*r[1] + r[2]*r[2];
+        const double w = SHADOW_R_EARTH_KM + PRETEST_SLACK_KM - slope*d;
+        state[i] = (unsigned char)((w > 0.0) & (r2 - d*d < w*w));
+    }
+    // Pass 2: exact geometry for the candidates.
+    size_t exact = 0;
+    for(size_t i=0;i<n;i++){
+        if(!state[i]) continue;
+        const double* r = xyz + i*stride;
+        state[i] = shadow_state(r[0], r[1], r[2], sun);
+        exact++;
+    }
+    return exact;
+}
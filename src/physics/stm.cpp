@@ -0,0 +1,142 @@
+#include "physics/stm.hpp"
+#include <cmath>
+
+static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
+
+StmPropagator::StmPropagator(double j2_k) : j2_k(j2_k) {}
+
+void StmPropagator::reset(const Body* b, size_t n){
+    for(auto* v : {&x, &y, &z, &vx, &vy, &vz, &mass, &ax, &ay, &az,
+                   &gxx, &gxy, &gxz, &gyy, &gyz, &gzz}) v->resize(n);
+    for(size_t i=0;i<n;i++){
+        x[i] = b[i].x; y[i] = b[i].y; z[i] = b[i].z;
+        vx[i] = b[i].vx; vy[i] = b[i].vy; vz[i] = b[i].vz;
+        mass[i] = b[i].mass;
+    }
+    phi.assign(36*n, 0.0);
+    for(int k=0;k<6;k++) std::fill(phi.begin() + (7*k)*n, phi.begin() + (7*k + 1)*n, 1.0);
+    t = 0.0;
+}
+
+// v1 = v0 + a(r0) dt, r1 = r0 + v1 dt, so with G = da/dr at r0:
+// phi_v += dt G phi_r, then phi_r += dt phi_v.
+void StmPropagator::step(double dt){
+    const size_t n = size();
+    const double k = j2_k;
+    double* __restrict px = x.data(); double* __restrict py = y.data(); double* __restrict pz = z.data();
+    double* __restrict pvx = vx.data(); double* __restrict pvy = vy.data(); double* __restrict pvz = vz.data();
+    double* __restrict qx = ax.data(); double* __restrict qy = ay.data(); double* __restrict qz = az.data();
+    double* __restrict g0 = gxx.data(); double* __restrict g1 = gxy.data(); double* __restrict g2 = gxz.data();
+    double* __restrict g3 = gyy.data(); double* __restrict g4 = gyz.data(); double* __restrict g5 = gzz.data();
+
+    for(size_t i=0;i<n;i++){
+        const double rx = px[i], ry = py[i], rz = pz[i];
+        const double r2 = rx*rx + ry*ry + rz*rz;
+        const double inv_r2 = 1.0/r2;
+        const double inv_r3 = inv_r2/std::sqrt(r2);
+        const double inv_r5 = inv_r3*inv_r2, inv_r7 = inv_r5*inv_r2, inv_r9 = inv_r7*inv_r2;
+        // central: a = -mu r/r^3, G = -mu/r^3 (I - 3 r r^T/r^2)
+        const double m3 = MU_E_KM3_S2*inv_r3, m5 = 3.0*MU_E_KM3_S2*inv_r5;
+        // J2: a = -k r^-5 (x(1 - 5s), y(1 - 5s), z(3 - 5s)), s = z^2/r^2
+        const double z2 = rz*rz, z2r7 = 5.0*z2*inv_r7;
+        const double kxy = -k*(35.0*z2*inv_r9 - 5.0*inv_r7);
+        const double kz = -k*(35.0*z2*inv_r9 - 15.0*inv_r7)*rz;
+        qx[i] = -m3*rx - k*rx*(inv_r5 - z2r7);
+        qy[i] = -m3*ry - k*ry*(inv_r5 - z2r7);
+        qz[i] = -m3*rz - k*rz*(3.0*inv_r5 - z2r7);
+        g0[i] = -m3 + m5*rx*rx - k*(inv_r5 - z2r7) + kxy*rx*rx;
+        g1[i] = m5*rx*ry + kxy*rx*ry;
+        g2[i] = m5*rx*rz + kz*rx;
+        g3[i] = -m3 + m5*ry*ry - k*(inv_r5 - z2r7) + kxy*ry*ry;
+        g4[i] = m5*ry*rz + kz*ry;
+        g5[i] = -m3 + m5*z2 - k*(3.0*inv_r5 - 30.0*z2*inv_r7 + 35.0*z2*z2*inv_r9);
+    }
+    for(size_t i=0;i<n;i++){
+        pvx[i] += qx[i]*dt; pvy[i] += qy[i]*dt; pvz[i] += qz[i]*dt;
+        px[i] += pvx[i]*dt; py[i] += pvy[i]*dt; pz[i] += pvz[i]*dt;
+    }
+    for(int c=0;c<6;c++){
+        double* __restrict r0 = phi.data() + (c)*n;
+        double* __restrict r1 = phi.data() + (6 + c)*n;
+        double* __restrict r2 = phi.data() + (12 + c)*n;
+        double* __restrict v0 = phi.data() + (18 + c)*n;
+        double* __restrict v1 = phi.data() + (24 + c)*n;
+        double* __restrict v2 = phi.data() + (30 + c)*n;
+        for(size_t i=0;i<n;i++){
+            const double a = r0[i], b = r1[i], d = r2[i];
+            v0[i] += dt*(g0[i]*a + g1[i]*b + g2[i]*d);
+            v1[i] += dt*(g1[i]*a + g3[i]*b + g4[i]*d);
+            v2[i] += dt*(g2[i]*a + g4[i]*b + g5[i]*d);
+            r0[i] = a + dt*v0[i];
+            r1[i] = b + dt*v1[i];
+            r2[i] = d + dt*v2[i];
+        }
+    }
+    t += dt;
+}
+
+void StmPropagator::propagate(double t_end, double dt){
+    while(t + dt < t_end) step(dt);
+    if(t_end > t) step(t_end - t);
+}
+
+Body StmPropagator::state(size_t i) const {
+    return Body{x[i], y[i], z[i], vx[i], vy[i], vz[i], mass[i]};
+}
+
+void StmPropagator::stm(size_t i, double out[6][6]) const {
+    const size_t n = size();
+    for(int r=0;r<6;r++)
+        for(int c=0;c<6;c++) out[r][c] = phi[(6*r + c)*n + i];
+}
+
+void propagate_covariance(const double phi[6][6], const double p0[6][6], double p[6][6]){
+    double tmp[6][6];
+    for(int r=0;r<6;r++)
+        for(int c=0;c<6;c++){
+            double s = 0.0;
+            for(int k=0;k<6;k++) s += phi[r][k]*p0[k][c];
+            tmp[r][c] = s;
+        }
+    for(int r=0;r<6;r++)
+        for(int c=0;c<6;c++){
+            double s = 0.0;
+            for(int k=0;k<6;k++) s += tmp[r][k]*phi[c][k];
+            p[r][c] = s;
+        }
+}
+
+bool correct_velocity(const double phi[6][6], const double miss[3], double dv[3]){
+    // Cramer's rule on the position-from-velocity block.
+    const double (*m)[6] = phi;
+    const double a = m[0][3], b = m[0][4], c = m[0][5];
+    const double d = m[1][3], e = m[1][4], f = m[1][5];
+    const double g = m[2][3], h = m[2][4], k = m[2][5];
+    const double A = e*k - f*h, B = f*g - d*k, C = d*h - e*g;
+    const double det = a*A + b*B + c*C;
+    const double scale = std::fabs(a) + std::fabs(b) + std::fabs(c) + std::fabs(d) + std::fabs(e)
+                       + std::fabs(f) + std::fabs(g) + std::fabs(h) + std::fabs(k);
+    if(!(std::fabs(det) > 1e-12*scale*scale*scale)) return false;
+    const double inv = 1.0/det;
+    dv[0] = inv*(A*miss[0] + (c*h - b*k)*miss[1] + (b*f - c*e)*miss[2]);
+    dv[1] = inv*(B*miss[0] + (a*k - c*g)*miss[1] + (c*d - a*f)*miss[2]);
+    dv[2] = inv*(C*miss[0] + (b*g - a*h)*miss[1] + (a*e - b*d)*miss[2]);
+    return true;
+}
+
+int target_position(Body& b0, const std::array<double,3>& r_target, double tof, double dt,
+                    double j2_k, double tol_km, int max_iter){
+    StmPropagator p(j2_k);
+    for(int it=1; it<=max_iter; it++){
+        p.reset(&b0, 1);
+        p.propagate(tof, dt);
+        const Body b = p.state(0);
+        const double miss[3] = {r_target[0] - b.x, r_target[1] - b.y, r_target[2] - b.z};
+        if(std::sqrt(miss[0]*miss[0] + miss[1]*miss[1] + miss[2]*miss[2]) < tol_km) return it - 1;
+        double m[6][6], dv[3];
+        p.stm(0, m);
+        if(!correct_velocity(m, miss, dv)) return -1;
+        b0.vx += dv[0]; b0.vy += dv[1]; b0.vz += dv[2];
+    }
+    return -1;
+}
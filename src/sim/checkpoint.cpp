@@ -0,0 +1,226 @@
+#include "sim/checkpoint.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+
+static_assert(std::is_trivially_copyable_v<Body>, "Body must be trivially copyable for checkpoints");
+static_assert(std::is_trivially_copyable_v<Stage>, "Stage must be trivially copyable for checkpoints");
+
+static constexpr char CKPT_MAGIC[8] = {'S','S','2','C','K','P','T','\0'};
+static constexpr uint32_t CKPT_VERSION = 2;
+
+namespace {
+
+struct Writer{
+    std::string buf;
+    template<class T> void pod(const T& v){
+        static_assert(std::is_trivially_copyable_v<T>);
+        buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+    template<class T> void vec(const std::vector<T>& v){
+        pod<uint64_t>(v.size());
+        buf.append(reinterpret_cast<const char*>(v.data()), v.size()*sizeof(T));
+    }
+    void str(const std::string& s){
+        pod<uint64_t>(s.size());
+        buf.append(s);
+    }
+};
+
+struct Reader{
+    const char* p;
+    const char* end;
+    bool ok=true;
+    bool take(void* dst,size_t n){
+        if(!ok || (size_t)(end-p) < n){ ok=false; return false; }
+        std::memcpy(dst,p,n); p+=n;
+        return true;
+    }
+    template<class T> void pod(T& v){ take(&v,sizeof(T)); }
+    template<class T> void vec(std::vector<T>& v){
+        uint64_t n=0; pod(n);
+        if(!ok || n > (uint64_t)(end-p)/sizeof(T)){ ok=false; return; }
+        v.resize(n);
+        take(v.data(), n*sizeof(T));
+    }
+    void str(std::string& s){
+        uint64_t n=0; pod(n);
+        if(!ok || n > (uint64_t)(end-p)){ ok=false; return; }
+        s.assign(p,n); p+=n;
+    }
+};
+
+}
+
+static std::string serialize(const Checkpoint& c){
+    Writer w;
+    w.buf.reserve(64 + c.bodies.size()*(sizeof(Body)+24));
+    w.buf.append(CKPT_MAGIC, sizeof(CKPT_MAGIC));
+    w.pod(CKPT_VERSION);
+    w.pod<uint32_t>(sizeof(Body));
+    w.pod(c.t); w.pod(c.dt); w.pod(c.t_end); w.pod(c.engine_time);
+    w.vec(c.bodies);
+    w.pod<uint64_t>(c.names.size());
+    for(const auto& n : c.names) w.str(n);
+
+    w.pod<uint8_t>(c.has_rocket);
+    if(c.has_rocket){
+        const auto& r=c.rocket;
+        w.vec(r.stages);
+        w.pod<uint64_t>(r.cur);
+        w.pod(r.fuel); w.pod(r.dry); w.pod(r.mass);
+        w.pod(r.s);
+        w.pod<uint8_t>(r.sep); w.pod<uint8_t>(r.powered); w.pod<uint8_t>(r.is_dead);
+    }
+
+    w.vec(c.model_state);
+
+    w.pod<uint8_t>(c.has_output);
+    w.pod(c.output_next_t);
+    w.pod(c.output_offset);
+    return std::move(w.buf);
+}
+
+Checkpoint capture_checkpoint(const PhysicsEngine& e,double t_next,double dt,double t_end,OutputWriter* ow){
+    Checkpoint c;
+    c.t = t_next;
+    c.dt = dt;
+    c.t_end = t_end;
+    c.engine_time = e.time;
+    c.bodies = e.bodies;
+    c.names = e.names;
+    if(ow && ow->enabled()){
+        c.has_output = true;
+        c.output_next_t = ow->next_time();
+        c.output_offset = ow->position();
+    }
+    return c;
+}
+
+bool save_checkpoint(const std::string& path,const Checkpoint& c){
+    const std::string data = serialize(c);
+    const std::string tmp = path + ".tmp";
+
+    int fd = ::open(tmp.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if(fd < 0) return false;
+    const char* p = data.data();
+    size_t left = data.size();
+    while(left > 0){
+        ssize_t n = ::write(fd, p, left);
+        if(n <= 0){ ::close(fd); return false; }
+        p += n; left -= (size_t)n;
+    }
+    if(::fsync(fd) != 0){ ::close(fd); return false; }
+    ::close(fd);
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool load_checkpoint(const std::string& path,Checkpoint& c){
+    std::ifstream f(path, std::ios::binary);
+    if(!f) return false;
+    const std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    Reader r{data.data(), data.data()+data.size()};
+    char magic[sizeof(CKPT_MAGIC)];
+    uint32_t version=0, body_size=0;
+    r.take(magic, sizeof(magic));
+    r.pod(version); r.pod(body_size);
+    if(!r.ok || std::memcmp(magic, CKPT_MAGIC, sizeof(magic)) != 0 ||
+       version != CKPT_VERSION || body_size != sizeof(Body)){
+        std::cerr << "load_checkpoint: incompatible checkpoint " << path << "\n";
+        return false;
+    }
+
+    c = Checkpoint{};
+    r.pod(c.t); r.pod(c.dt); r.pod(c.t_end); r.pod(c.engine_time);
+    r.vec(c.bodies);
+    uint64_t n_names=0; r.pod(n_names);
+    if(r.ok && n_names <= c.bodies.size()){
+        c.names.resize(n_names);
+        for(auto& n : c.names) r.str(n);
+    }else{
+        r.ok=false;
+    }
+
+    uint8_t flag=0;
+    r.pod(flag); c.has_rocket = flag;
+    if(c.has_rocket){
+        auto& rc=c.rocket;
+        uint64_t cur=0;
+        r.vec(rc.stages);
+        r.pod(cur); rc.cur=(size_t)cur;
+        r.pod(rc.fuel); r.pod(rc.dry); r.pod(rc.mass);
+        r.pod(rc.s);
+        r.pod(flag); rc.sep=flag;
+        r.pod(flag); rc.powered=flag;
+        r.pod(flag); rc.is_dead=flag;
+    }
+
+    r.vec(c.model_state);
+
+    r.pod(flag); c.has_output=flag;
+    r.pod(c.output_next_t);
+    r.pod(c.output_offset);
+
+    if(!r.ok){
+        std::cerr << "load_checkpoint: truncated checkpoint " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+Checkpointer::~Checkpointer(){
+    finish();
+}
+
+void Checkpointer::open(const std::string& dir,double every_s,double t_start){
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    path = (std::filesystem::path(dir) / "latest.ckpt").string();
+    every = every_s;
+    next_t = t_start + every_s;
+    is_on = every_s > 0.0;
+    if(is_on) worker = std::thread(&Checkpointer::run, this);
+}
+
+void Checkpointer::submit(double t,Checkpoint&& c){
+    if(!is_on) return;
+    while(next_t <= t + 1e-9) next_t += every;
+    {
+        std::lock_guard<std::mutex> lk(m);
+        pending = std::move(c);
+        has_pending = true;
+    }
+    cv.notify_one();
+}
+
+void Checkpointer::finish(){
+    if(!worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lk(m);
+        stop = true;
+    }
+    cv.notify_one();
+    worker.join();
+}
+
+void Checkpointer::run(){
+    std::unique_lock<std::mutex> lk(m);
+    while(true){
+        cv.wait(lk, [&]{ return has_pending || stop; });
+        if(!has_pending && stop) return;
+
+        Checkpoint c = std::move(pending);
+        has_pending = false;
+        lk.unlock();
+        if(!save_checkpoint(path, c)){
+            std::cerr << "checkpoint: failed to write " << path << "\n";
+        }
+        lk.lock();
+    }
+}
@@ -3,9 +3,13 @@
 #include "core/tle.hpp"
 #include "core/tle_to_coe.hpp"
 #include "physics/orbit.hpp"
+#include "core/parallel.hpp"
 
+#include <charconv>
 #include <fstream>
+#include <future>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <cctype>
@@ -14,6 +18,9 @@
 static constexpr double MU_E_KM3_S2 = 398600.4418;
 static constexpr double RAD2DEG = 180.0 / M_PI;
 
+// Records converted per pipeline chunk; bounds memory independent of catalog size.
+static constexpr size_t EXPAND_CHUNK = 16384;
+
 static std::string trim(const std::string& s){
     size_t a = 0;
     while(a < s.size() && std::isspace((unsigned char)s[a])) a++;
@@ -56,15 +63,24 @@ static std::string sanitize_name(const std::string& name){
     return collapsed;
 }
 
-static std::string make_unique(std::unordered_set<std::string>& used, const std::string& base){
-    if(!used.count(base)){
-        used.insert(base);
+// Suffix search resumes from the last suffix handed out for each base, so
+// heavily duplicated catalog names stay linear instead of rescanning _2.._k.
+struct NameRegistry{
+    std::unordered_set<std::string> used;
+    std::unordered_map<std::string,int> next_suffix;
+};
+
+static std::string make_unique(NameRegistry& reg, const std::string& base){
+    if(!reg.used.count(base)){
+        reg.used.insert(base);
         return base;
     }
-    for(int i=2;i<1000000;i++){
+    int& i = reg.next_suffix.try_emplace(base, 2).first->second;
+    for(;i<1000000;i++){
         std::string c = base + "_" + std::to_string(i);
-        if(!used.count(c)){
-            used.insert(c);
+        if(!reg.used.count(c)){
+            reg.used.insert(c);
+            i++;
             return c;
         }
     }
@@ -72,22 +88,49 @@ static std::string make_unique(std::unordered_set<std::string>& used, const std:
     return base + "_X";
 }
 
+// Shortest round-trip representation (std::to_chars), no locale, no stream state.
+static void append_kv(std::string& out, const char* key, double v){
+    char buf[64];
+    auto r = std::to_chars(buf, buf + sizeof(buf), v);
+    out += key;
+    out.append(buf, r.ptr);
+    out += '\n';
+}
+
+static void append_entity(std::string& out, const std::string& nm, const TLE& t){
+    COE c{};
+    tle_to_coe(t, MU_E_KM3_S2, c);
+
+    out += "\nentity "; out += nm; out += '\n';
+    out += "type satellite\n";
+    out += "coe\n";
+    append_kv(out, "a_km ",     c.a);
+    append_kv(out, "e ",        c.e);
+    append_kv(out, "i_deg ",    c.i * RAD2DEG);
+    append_kv(out, "raan_deg ", c.raan * RAD2DEG);
+    append_kv(out, "argp_deg ", c.argp * RAD2DEG);
+    append_kv(out, "ta_deg ",   c.ta * RAD2DEG);
+}
+
 bool expand_scenario_with_tles(const std::string& in_path,
                                const std::string& out_path)
 {
     std::ifstream in(in_path);
     if(!in) return false;
 
-    std::vector<std::string> kept_lines;
-    kept_lines.reserve(2048);
+    std::ofstream out(out_path, std::ios::binary);
+    if(!out) return false;
 
     std::vector<std::string> tle_paths;
+    NameRegistry used_names;
 
+    // stream original scenario content without tle_file lines, seeding
+    // used_names from existing "entity <name>" lines to avoid collisions
     std::string line;
     while(std::getline(in, line)){
         std::string t = trim(line);
         if(t.empty()){
-            kept_lines.push_back(line);
+            out << line << "\n";
             continue;
         }
         // strip comments starting with '#'
@@ -105,59 +148,59 @@ bool expand_scenario_with_tles(const std::string& in_path,
             // do NOT keep this line in the output (we expand it)
             continue;
         }
-        kept_lines.push_back(line);
-    }
-
-    // load all TLEs referenced
-    std::vector<TLE> all;
-    for(const auto& p : tle_paths){
-        std::vector<TLE> tles;
-        if(load_tles_from_file(p, tles)){
-            all.insert(all.end(), tles.begin(), tles.end());
-        }
-    }
-
-    std::ofstream out(out_path);
-    if(!out) return false;
-
-    // write original scenario content without tle_file lines
-    for(const auto& l : kept_lines) out << l << "\n";
-
-    if(!all.empty()){
-        out << "\n# --- Expanded TLE entities (" << all.size() << ") ---\n";
-    }
-
-    std::unordered_set<std::string> used_names;
-
-    // try to seed used_names from existing "entity <name>" lines to avoid collisions
-    for(const auto& l : kept_lines){
-        std::string t = trim(l);
         if(starts_with(t, "entity ")){
             std::istringstream iss(t);
             std::string kw, nm;
             iss >> kw >> nm;
-            if(!nm.empty()) used_names.insert(nm);
+            if(!nm.empty()) used_names.used.insert(nm);
         }
+        out << line << "\n";
+    }
+
+    size_t total = 0;
+    for(const auto& p : tle_paths) total += count_tles_in_file(p);
+    if(total > 0){
+        out << "\n# --- Expanded TLE entities (" << total << ") ---\n";
     }
 
-    // append each TLE as an entity with COE fields in degrees
-    for(const auto& t : all){
-        COE c{};
-        tle_to_coe(t, MU_E_KM3_S2, c);
-
-        std::string base = sanitize_name(t.name);
-        std::string nm = make_unique(used_names, base);
-
-        out << "\nentity " << nm << "\n";
-        out << "type satellite\n";
-        out << "coe\n";
-        out << "a_km "    << c.a << "\n";
-        out << "e "       << c.e << "\n";
-        out << "i_deg "   << (c.i * RAD2DEG) << "\n";
-        out << "raan_deg "<< (c.raan * RAD2DEG) << "\n";
-        out << "argp_deg "<< (c.argp * RAD2DEG) << "\n";
-        out << "ta_deg "  << (c.ta * RAD2DEG) << "\n";
+    // Pipeline: parse + name de-dup (ordered, this thread) -> COE conversion
+    // and formatting (parallel slices) -> write (async, in chunk order).
+    // At most one chunk is being written while the next is parsed/converted.
+    std::vector<TLE> tles;
+    std::vector<std::string> names;
+    tles.reserve(EXPAND_CHUNK);
+    names.reserve(EXPAND_CHUNK);
+
+    std::future<void> writing;
+    auto convert_and_write = [&](){
+        if(tles.empty()) return;
+        const size_t n = tles.size();
+        std::vector<std::string> text(parallel_slices(n, 512));
+        parallel_for(n, 512, [&](size_t b, size_t e, size_t s){
+            std::string& buf = text[s];
+            buf.reserve((e - b) * 160);
+            for(size_t k=b;k<e;k++) append_entity(buf, names[k], tles[k]);
+        });
+        if(writing.valid()) writing.get();
+        writing = std::async(std::launch::async, [&out, text = std::move(text)](){
+            for(const auto& buf : text) out.write(buf.data(), (std::streamsize)buf.size());
+        });
+        tles.clear();
+        names.clear();
+    };
+
+    for(const auto& p : tle_paths){
+        std::ifstream f(p);
+        if(!f) continue;
+        TLE t;
+        while(read_next_tle(f, t)){
+            names.push_back(make_unique(used_names, sanitize_name(t.name)));
+            tles.push_back(std::move(t));
+            if(tles.size() == EXPAND_CHUNK) convert_and_write();
+        }
     }
+    convert_and_write();
+    if(writing.valid()) writing.get();
 
-    return true;
+    return (bool)out;
 }
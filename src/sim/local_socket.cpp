@@ -0,0 +1,76 @@
+#include "sim/local_socket.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static bool parse_endpoint(const std::string& ep, sockaddr_storage& addr, socklen_t& len, std::string& unix_path){
+    std::memset(&addr, 0, sizeof(addr));
+    unix_path.clear();
+    if(ep.compare(0, 5, "unix:") == 0){
+        sockaddr_un* a = (sockaddr_un*)&addr;
+        const std::string path = ep.substr(5);
+        if(path.empty() || path.size() >= sizeof(a->sun_path)) return false;
+        a->sun_family = AF_UNIX;
+        std::memcpy(a->sun_path, path.c_str(), path.size() + 1);
+        len = sizeof(sockaddr_un);
+        unix_path = path;
+        return true;
+    }
+    if(ep.compare(0, 4, "tcp:") == 0){
+        sockaddr_in* a = (sockaddr_in*)&addr;
+        char* end = nullptr;
+        const long port = std::strtol(ep.c_str() + 4, &end, 10);
+        if(end == ep.c_str() + 4 || *end || port <= 0 || port > 65535) return false;
+        a->sin_family = AF_INET;
+        a->sin_port = htons((uint16_t)port);
+        a->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        len = sizeof(sockaddr_in);
+        return true;
+    }
+    return false;
+}
+
+int local_listen(const std::string& endpoint, std::string& unix_path, const char* who){
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    if(!parse_endpoint(endpoint, addr, len, unix_path)){
+        std::cerr << who << ": bad endpoint '" << endpoint << "' (unix:<path> or tcp:<port>)\n";
+        return -1;
+    }
+    const int fd = ::socket(addr.ss_family, SOCK_STREAM, 0);
+    if(fd < 0){
+        std::cerr << who << ": socket: " << std::strerror(errno) << "\n";
+        return -1;
+    }
+    if(!unix_path.empty()) ::unlink(unix_path.c_str());
+    const int one = 1;
+    if(unix_path.empty()) ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if(::bind(fd, (sockaddr*)&addr, len) != 0 || ::listen(fd, 16) != 0){
+        std::cerr << who << ": cannot listen on " << endpoint << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return -1;
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+int local_connect(const std::string& endpoint){
+    sockaddr_storage addr;
+    socklen_t len = 0;
+    std::string path;
+    if(!parse_endpoint(endpoint, addr, len, path)) return -1;
+    const int fd = ::socket(addr.ss_family, SOCK_STREAM, 0);
+    if(fd < 0) return -1;
+    if(::connect(fd, (sockaddr*)&addr, len) != 0){
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
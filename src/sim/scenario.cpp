@@ -3,6 +3,7 @@
 #include "physics/engine.hpp"
 #include "core/tle.hpp"
 #include "core/geodesy.hpp"
+#include "core/frames.hpp"
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -13,46 +14,84 @@
 static constexpr double MU_E_KM3_S2 = 398600.4418; // km^3/s^2
 static constexpr double DEG2RAD = 3.14159265358979323846/180.0;
 
-// Earth rotation rate (rad/s). If we treat ECEF as ECI at t=0, adding this gives surface co-rotation velocity.
-// Units: (rad/s) * km = km/s.
-static constexpr double OMEGA_E_RAD_S = 7.2921159e-5;
+static bool set_cfg_key(ScenarioCfg& cfg,const std::string& k,double v){
+    if(k=="duration_seconds"){ cfg.t_end = v; }
+    else if(k=="timestep_seconds"){ cfg.dt = v; }
+    else if(k=="epoch_jd"){ cfg.epoch_jd = v; }
+    else if(k=="third_body"){ cfg.third_body = (v != 0.0); }
+    else if(k=="gravity_degree"){ cfg.gravity_degree = (int)v; }
+    else if(k=="gravity_order"){ cfg.gravity_order = (int)v; }
+    else if(k=="propagator"){ cfg.propagator = (int)v; }
+    else if(k=="drag"){ cfg.drag = (v != 0.0); }
+    else if(k=="srp"){ cfg.srp = (v != 0.0); }
+    else if(k=="catalog_mass_kg"){ cfg.catalog_mass_kg = v; }
+    else if(k=="catalog_area_m2"){ cfg.catalog_area_m2 = v; }
+    else if(k=="catalog_cd"){ cfg.catalog_cd = v; }
+    else if(k=="catalog_cr"){ cfg.catalog_cr = v; }
+    else return false;
+    return true;
+}
 
-ScenarioCfg load_scenario(const std::string& path, PhysicsEngine& e){
-    ScenarioCfg cfg{};
-    cfg.dt = 1.0;
-    cfg.t_end = 3600.0;
-
-    struct Ent{
-        std::string name;
-        std::string type;
-        COE coe{};
-        bool has_coe=false;
-
-        // Rocket launch params (degrees in scenario file)
-        double launch_lat_deg = 0.0;
-        double launch_lon_deg = 0.0;
-        double launch_az_deg  = 90.0;
-        bool has_launch = false;
-    };
+static bool set_entity_key(ScenarioEntity& en,const std::string& k,double v){
+    if(k=="a_km"){
+        en.coe.a = v;
+    }else if(k=="e"){
+        en.coe.e = v;
+    }else if(k=="i_deg"){
+        en.coe.i = v * DEG2RAD;
+    }else if(k=="raan_deg"){
+        en.coe.raan = v * DEG2RAD;
+    }else if(k=="argp_deg"){
+        en.coe.argp = v * DEG2RAD;
+    }else if(k=="ta_deg"){
+        en.coe.ta = v * DEG2RAD;
+    }
+    // Drag/SRP surface
+    else if(k=="mass_kg"){
+        en.mass_kg = v;
+    }else if(k=="area_m2"){
+        en.area_m2 = v;
+    }else if(k=="cd"){
+        en.cd = v;
+    }else if(k=="cr"){
+        en.cr = v;
+    }
+    // Rocket launch keys
+    else if(k=="launch_lat"){
+        en.launch_lat_deg = v;
+        en.has_launch = true;
+    }else if(k=="launch_lon"){
+        en.launch_lon_deg = v;
+        en.has_launch = true;
+    }else if(k=="launch_az_deg"){
+        en.launch_az_deg = v;
+        en.has_launch = true;
+    }
+    else return false;
+    return true;
+}
 
-    std::vector<Ent> ents;
-    std::string tle_path;
+bool parse_scenario(const std::string& path, ScenarioDef& def){
+    def = ScenarioDef{};
+    def.cfg.dt = 1.0;
+    def.cfg.t_end = 3600.0;
 
     std::ifstream f(path);
     if(!f){
         std::cerr << "load_scenario: failed to open " << path << "\n";
-        return cfg;
+        return false;
     }
 
     std::string line;
-    Ent cur{};
+    ScenarioEntity cur{};
     bool in_entity=false;
+    bool has_model=false;
 
     auto flush_entity = [&](){
         if(in_entity && !cur.name.empty()){
-            ents.push_back(cur);
+            def.ents.push_back(cur);
         }
-        cur = Ent{};
+        cur = ScenarioEntity{};
         in_entity=false;
     };
 
@@ -63,9 +102,7 @@ ScenarioCfg load_scenario(const std::string& path, PhysicsEngine& e){
         ss >> k;
         if(k.empty()) continue;
 
-        if(k=="duration_seconds"){ ss >> cfg.t_end; }
-        else if(k=="timestep_seconds"){ ss >> cfg.dt; }
-        else if(k=="entity"){
+        if(k=="entity"){
             flush_entity();
             in_entity=true;
             ss >> cur.name;
@@ -73,81 +110,163 @@ ScenarioCfg load_scenario(const std::string& path, PhysicsEngine& e){
             ss >> cur.type;
         }else if(k=="coe"){
             cur.has_coe=true;
-        }else if(k=="a_km"){
-            ss >> cur.coe.a;
-        }else if(k=="e"){
-            ss >> cur.coe.e;
-        }else if(k=="i_deg"){
-            ss >> cur.coe.i; cur.coe.i *= DEG2RAD;
-        }else if(k=="raan_deg"){
-            ss >> cur.coe.raan; cur.coe.raan *= DEG2RAD;
-        }else if(k=="argp_deg"){
-            ss >> cur.coe.argp; cur.coe.argp *= DEG2RAD;
-        }else if(k=="ta_deg"){
-            ss >> cur.coe.ta; cur.coe.ta *= DEG2RAD;
         }else if(k=="tle_file"){
-            ss >> tle_path;
-        }
-        // Rocket launch keys
-        else if(k=="launch_lat"){
-            ss >> cur.launch_lat_deg;
-            cur.has_launch = true;
-        }else if(k=="launch_lon"){
-            ss >> cur.launch_lon_deg;
-            cur.has_launch = true;
-        }else if(k=="launch_az_deg"){
-            ss >> cur.launch_az_deg;
-            cur.has_launch = true;
+            ss >> def.tle_path;
+        }else if(k=="propagator"){
+            std::string p;
+            ss >> p;
+            if(p=="secular_j2") def.cfg.propagator = PROPAGATOR_SECULAR_J2;
+            else if(p=="numeric") def.cfg.propagator = PROPAGATOR_NUMERIC;
+            else std::cerr << "load_scenario: unknown propagator '" << p << "'\n";
+        }else if(k=="model"){
+            std::string m;
+            ss >> m;
+            if(m=="orbit") def.cfg.model = MODEL_ORBIT;
+            else if(m=="tle_hour") def.cfg.model = MODEL_TLE_HOUR;
+            else if(m=="rocket") def.cfg.model = MODEL_ROCKET;
+            else if(m=="lambert_demo") def.cfg.model = MODEL_LAMBERT_DEMO;
+            else std::cerr << "load_scenario: unknown model '" << m << "'\n";
+            has_model = true;
+        }else{
+            double v;
+            if(!(ss >> v)) continue;
+            if(!set_cfg_key(def.cfg, k, v)) set_entity_key(cur, k, v);
         }
         // NOTE: stages are currently handled inside rocket_model.cpp (hardcoded). We parse launch only for now.
     }
     flush_entity();
+    if(!has_model){
+        for(const auto& en : def.ents)
+            if(en.type=="rocket") def.cfg.model = MODEL_ROCKET;
+    }
+
+    // Load TLE satellites (each becomes an entity)
+    if(!def.tle_path.empty()){
+        std::vector<TLE> tles;
+        if(load_tles_from_file(def.tle_path, tles)){
+            auto cat = std::make_shared<ScenarioCatalog>();
+            cat->bodies.reserve(tles.size());
+            cat->names.reserve(tles.size());
+            for(const auto& t : tles){
+                double x,y,z,vx,vy,vz;
+                tle_mean_to_eci(t, MU_E_KM3_S2, x,y,z,vx,vy,vz);
+                Body b;
+                b.x=x; b.y=y; b.z=z;
+                b.vx=vx; b.vy=vy; b.vz=vz;
+                b.mass=0;
+                cat->bodies.push_back(b);
+                cat->names.push_back(t.name);
+            }
+            def.catalog = std::move(cat);
+        }
+    }
+    return true;
+}
+
+ScenarioCfg build_scenario(const ScenarioDef& def, PhysicsEngine& e){
+    const size_t first = e.bodies.size();
+    std::vector<BodySurface> surf;
+    bool any_surface = false;
 
     // Add explicit scenario entities
-    for(const auto& en : ents){
+    for(const auto& en : def.ents){
+        const size_t before = e.bodies.size();
         if(en.type=="satellite" && en.has_coe){
             Body b = coe_to_body_eci(en.coe);
+            if(en.mass_kg > 0.0) b.mass = en.mass_kg;
             e.add(b, en.name);
         }else if(en.type=="rocket"){
-            // Spawn rocket at the given launch site on Earth's surface (alt_km=0)
-            // Using simple spherical Earth ECEF. Treat ECEF==ECI at t=0.
+            // Spawn rocket at the given launch site on Earth's surface (alt_km=0):
+            // WGS-84 ECEF at rest on the ground, rotated into ECI by GMST at the
+            // scenario epoch (the w x r term gives the co-rotation velocity).
             double alt_km = 0.0;
             if(!en.has_launch){
                 std::cerr << "rocket entity '" << en.name << "' missing launch_lat/launch_lon; defaulting to 0,0\n";
             }
             auto r_ecef = lla_to_ecef(en.launch_lat_deg, en.launch_lon_deg, alt_km);
+            const double v_ecef[3] = {0.0, 0.0, 0.0};
+            double r_eci[3], v_eci[3];
+            ecef_to_eci(gmst_rad(def.cfg.epoch_jd), r_ecef.data(), v_ecef, r_eci, v_eci);
 
             Body b;
-            b.x = r_ecef[0];
-            b.y = r_ecef[1];
-            b.z = r_ecef[2];
-
-            // Initial velocity: Earth rotation (co-rotating ground)
-            // omega along +Z, v = omega x r = (-w*y, w*x, 0)
-            b.vx = -OMEGA_E_RAD_S * b.y;
-            b.vy =  OMEGA_E_RAD_S * b.x;
-            b.vz = 0.0;
+            b.x = r_eci[0];
+            b.y = r_eci[1];
+            b.z = r_eci[2];
+            b.vx = v_eci[0];
+            b.vy = v_eci[1];
+            b.vz = v_eci[2];
 
             b.mass = 0.0; // rocket_model.cpp will set mass from stage totals if mass<=0
             e.add(b, en.name);
         }
+        if(e.bodies.size() > before){
+            surf.push_back({en.area_m2, en.cd, en.cr});
+            any_surface = any_surface || en.area_m2 > 0.0;
+        }
     }
 
-    // Load TLE satellites (each becomes an entity)
-    if(!tle_path.empty()){
-        std::vector<TLE> tles;
-        if(load_tles_from_file(tle_path, tles)){
-            for(const auto& t : tles){
-                double x,y,z,vx,vy,vz;
-                tle_mean_to_eci(t, MU_E_KM3_S2, x,y,z,vx,vy,vz);
-                Body b;
-                b.x=x; b.y=y; b.z=z;
-                b.vx=vx; b.vy=vy; b.vz=vz;
-                b.mass=0;
-                e.add(b, t.name);
-            }
+    if(def.catalog){
+        const size_t cat0 = e.bodies.size();
+        e.bodies.insert(e.bodies.end(), def.catalog->bodies.begin(), def.catalog->bodies.end());
+        e.names.insert(e.names.end(), def.catalog->names.begin(), def.catalog->names.end());
+        const ScenarioCfg& c = def.cfg;
+        if(c.catalog_area_m2 > 0.0 && c.catalog_mass_kg > 0.0){
+            for(size_t i=cat0;i<e.bodies.size();i++) e.bodies[i].mass = c.catalog_mass_kg;
+            surf.resize(e.bodies.size() - first, {c.catalog_area_m2, c.catalog_cd, c.catalog_cr});
+            any_surface = true;
         }
     }
 
-    return cfg;
+    if(any_surface){
+        e.surfaces.resize(first);
+        e.surfaces.insert(e.surfaces.end(), surf.begin(), surf.end());
+    }
+
+    return def.cfg;
+}
+
+bool apply_scenario_override(ScenarioDef& def, const std::string& key, double value){
+    auto dot = key.find('.');
+    if(dot == std::string::npos) return set_cfg_key(def.cfg, key, value);
+
+    const std::string ent = key.substr(0, dot);
+    const std::string k   = key.substr(dot+1);
+    for(auto& en : def.ents){
+        if(en.name == ent) return set_entity_key(en, k, value);
+    }
+    return false;
+}
+
+ScenarioCfg load_scenario(const std::string& path, PhysicsEngine& e){
+    ScenarioDef def;
+    if(!parse_scenario(path, def)) return def.cfg;
+    return build_scenario(def, e);
+}
+
+bool configure_engine(PhysicsEngine& e, const ScenarioCfg& cfg, std::shared_ptr<const Ephemeris> eph){
+    e.ephemeris = std::move(eph);
+    e.time = 0.0;
+    e.epoch_jd = cfg.epoch_jd;
+    if(!e.set_gravity(cfg.gravity_degree, cfg.gravity_order)){
+        std::cerr << "configure_engine: unsupported gravity field " << cfg.gravity_degree
+                  << "x" << cfg.gravity_order << " (degree 2.." << GRAVITY_MAX_DEGREE << ")\n";
+        return false;
+    }
+    if(cfg.third_body){
+        if(!e.enable_third_body({"Sun","Moon"})){
+            std::cerr << "configure_engine: third_body needs an ephemeris with Sun and Moon\n";
+            return false;
+        }
+    }
+    e.set_drag(cfg.drag);
+    if(cfg.drag && e.drag_count() == 0)
+        std::cerr << "configure_engine: drag enabled but no body has area_m2 and mass\n";
+    e.set_srp(cfg.srp);
+    if(cfg.srp && e.srp_count() == 0)
+        std::cerr << "configure_engine: srp enabled but no body has area_m2 and mass\n";
+    if(!e.force_model()){
+        std::cerr << "configure_engine: no force pipeline for this combination of terms\n";
+        return false;
+    }
+    return true;
 }
@@ -1,25 +1,176 @@
 #include "sim/sim.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
 #include <thread>
+#include <vector>
 
-void run_sim(PhysicsEngine& e,const ScenarioCfg& cfg,double speed,const char*,OutputWriter* ow){
-    using clock=std::chrono::steady_clock;
-    auto last=clock::now();
-    double t=0.0;
+using SimClock = std::chrono::steady_clock;
 
-    while(t<=cfg.t_end){
-        auto now=clock::now();
-        std::chrono::duration<double> wall=now-last;
-        last=now;
+static double ms_between(SimClock::time_point a, SimClock::time_point b){
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+// Percentile by selection; reorders v.
+static double percentile(std::vector<double>& v, double p){
+    if(v.empty()) return 0.0;
+    const size_t k = std::min(v.size() - 1, (size_t)(p*(v.size() - 1) + 0.5));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+// Live speed control: the file holds one number, re-read when its
+// modification time changes.
+struct SpeedFile{
+    std::string path;
+    std::filesystem::file_time_type stamp{};
+    bool seen = false;
+
+    bool poll(double& speed){
+        std::error_code ec;
+        const auto t = std::filesystem::last_write_time(path, ec);
+        if(ec || (seen && t == stamp)) return false;
+        stamp = t;
+        seen = true;
+        std::ifstream in(path);
+        double s = 0.0;
+        if(!(in >> s) || !(s > 0.0)){
+            std::cerr << "run_sim: ignoring speed in " << path << "\n";
+            return false;
+        }
+        speed = s;
+        return true;
+    }
+};
+
+// Whole-run percentiles without keeping every sample: log bins 2% wide
+// from 1 us to 100 s.
+struct LatencyHistogram{
+    static constexpr double LO_MS = 1e-3;
+    static constexpr double RATIO = 1.02;
+    std::vector<size_t> bins = std::vector<size_t>(
+        (size_t)std::ceil(std::log(1e8)/std::log(RATIO)) + 2, 0);
+    size_t count = 0;
+
+    void add(double ms){
+        const double x = ms > LO_MS ? std::log(ms/LO_MS)/std::log(RATIO) + 1.0 : 0.0;
+        bins[std::min(bins.size() - 1, (size_t)x)]++;
+        count++;
+    }
+    double percentile(double p) const {
+        if(count == 0) return 0.0;
+        const size_t want = std::min(count, (size_t)(p*count) + 1);
+        size_t seen = 0;
+        for(size_t k=0;k<bins.size();k++){
+            seen += bins[k];
+            if(seen >= want) return k == 0 ? LO_MS : LO_MS*std::pow(RATIO, (double)k);
+        }
+        return LO_MS*std::pow(RATIO, (double)bins.size());
+    }
+};
+
+static void fill_stats(std::vector<double>& step_ms, std::vector<double>& late_ms, SimStats& s){
+    s.step_max_ms = step_ms.empty() ? 0.0 : *std::max_element(step_ms.begin(), step_ms.end());
+    s.step_p50_ms = percentile(step_ms, 0.50);
+    s.step_p99_ms = percentile(step_ms, 0.99);
+    s.jitter_p50_ms = percentile(late_ms, 0.50);
+    s.jitter_p99_ms = percentile(late_ms, 0.99);
+}
+
+static void print_stats(const char* tag, double t, double speed, const SimStats& s){
+    char line[320];
+    std::snprintf(line, sizeof(line),
+                  "%s t %.3f speed %g ticks %zu steps %zu step_p50_ms %.3f step_p99_ms %.3f step_max_ms %.3f"
+                  " jitter_p50_ms %.3f jitter_p99_ms %.3f overruns %zu missed_ticks %zu slip_s %.3f",
+                  tag, t, speed, s.ticks, s.steps, s.step_p50_ms, s.step_p99_ms, s.step_max_ms,
+                  s.jitter_p50_ms, s.jitter_p99_ms, s.overruns, s.missed_ticks, s.slip_s);
+    std::cout << line << std::endl;
+}
+
+SimStats run_sim(PhysicsEngine& e, const ScenarioCfg& cfg, const SimOptions& opt, OutputWriter* ow){
+    SimStats total, window;
+    double speed = opt.speed > 0.0 ? opt.speed : 1.0;
+    SpeedFile speed_file{opt.speed_file};
+    if(!(opt.speed > 0.0)) speed_file.poll(speed);
 
-        double dt_sim = wall.count()*speed;
-        int n = (dt_sim>0) ? (int)(dt_sim/cfg.dt) : 0;
-        if(n<1){ std::this_thread::sleep_for(std::chrono::milliseconds(1)); continue; }
+    const auto period = std::chrono::duration_cast<SimClock::duration>(
+        std::chrono::duration<double>(1.0/std::max(1e-3, opt.tick_hz)));
+    const double period_s = std::chrono::duration<double>(period).count();
 
-        for(int i=0;i<n && t<=cfg.t_end;i++){
+    std::vector<double> step_ms, late_ms;
+    LatencyHistogram all_step, all_late;
+    double t = 0.0, owed = 0.0;
+    auto deadline = SimClock::now();
+    auto last_wake = deadline;
+    auto next_report = deadline + std::chrono::duration_cast<SimClock::duration>(
+        std::chrono::duration<double>(opt.report_every_s));
+
+    while(t < cfg.t_end){
+        std::this_thread::sleep_until(deadline);
+        const auto wake = SimClock::now();
+        late_ms.push_back(ms_between(deadline, wake));
+
+        // Sim time owed since the last tick, paid in whole steps up to the
+        // tick's quota plus the catch-up budget.
+        owed += speed*std::chrono::duration<double>(wake - last_wake).count();
+        last_wake = wake;
+        const int quota = (int)std::ceil(speed*period_s/cfg.dt - 1e-9);
+        const int cap = std::max(1, quota) + std::max(0, opt.max_catchup_steps);
+        int n = (int)std::min<double>(std::floor(owed/cfg.dt + 1e-9), cap);
+        if(owed >= (cap + 1)*cfg.dt){
+            window.slip_s += owed - cap*cfg.dt;
+            owed = cap*cfg.dt;
+        }
+        n = std::min(n, (int)std::ceil((cfg.t_end - t)/cfg.dt - 1e-9));
+
+        for(int i=0;i<n;i++){
             e.step(cfg.dt);
-            t+=cfg.dt;
-            if(ow && ow->enabled()) ow->tick(t,e);
+            t += cfg.dt;
+            owed -= cfg.dt;
+            if(ow && ow->enabled()) ow->tick(t, e);
+        }
+        const auto done = SimClock::now();
+        step_ms.push_back(ms_between(wake, done));
+        window.ticks++;
+        window.steps += (size_t)std::max(0, n);
+
+        deadline += period;
+        if(done > deadline){
+            window.overruns++;
+            const auto behind = (done - deadline)/period;
+            window.missed_ticks += (size_t)behind;
+            deadline += period*(behind + 1);
+        }
+
+        if(done >= next_report || t >= cfg.t_end){
+            fill_stats(step_ms, late_ms, window);
+            print_stats("sim", t, speed, window);
+            total.ticks += window.ticks;
+            total.steps += window.steps;
+            total.overruns += window.overruns;
+            total.missed_ticks += window.missed_ticks;
+            total.slip_s += window.slip_s;
+            total.step_max_ms = std::max(total.step_max_ms, window.step_max_ms);
+            for(double v : step_ms) all_step.add(v);
+            for(double v : late_ms) all_late.add(v);
+            step_ms.clear();
+            late_ms.clear();
+            window = SimStats{};
+            next_report = done + std::chrono::duration_cast<SimClock::duration>(
+                std::chrono::duration<double>(opt.report_every_s));
+            if(!(opt.speed > 0.0)) speed_file.poll(speed);
         }
     }
+
+    // bins are 2% wide; never report above the observed max
+    total.step_p50_ms = std::min(all_step.percentile(0.50), total.step_max_ms);
+    total.step_p99_ms = std::min(all_step.percentile(0.99), total.step_max_ms);
+    total.jitter_p50_ms = all_late.percentile(0.50);
+    total.jitter_p99_ms = all_late.percentile(0.99);
+    print_stats("SIM_DONE", t, speed, total);
+    return total;
 }
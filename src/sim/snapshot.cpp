@@ -0,0 +1,182 @@
+#include "sim/snapshot.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::is_trivially_copyable_v<Body>, "Body must be trivially copyable for snapshots");
+static_assert(std::is_trivially_copyable_v<BodySurface>, "BodySurface must be trivially copyable for snapshots");
+static_assert(std::is_trivially_copyable_v<ScenarioCfg>, "ScenarioCfg must be trivially copyable for snapshots");
+
+static constexpr char SNAP_MAGIC[8] = {'S','S','2','S','N','A','P','\0'};
+static constexpr uint32_t SNAP_VERSION = 4;
+
+// File layout (all offsets from file start, bodies 8-byte aligned):
+//   SnapHeader | ScenarioCfg | Body[n_bodies] | BodySurface[n_surfaces]
+//   | uint32 name_len[n] | name bytes
+// n_surfaces is 0 (no drag/SRP surfaces) or n_bodies.
+struct SnapHeader{
+    char     magic[8];
+    uint32_t version;
+    uint32_t cfg_size;
+    uint32_t body_size;
+    uint32_t surface_size;
+    uint64_t n_bodies;
+    uint64_t n_surfaces;
+    uint64_t cfg_off;
+    uint64_t bodies_off;
+    uint64_t surfaces_off;
+    uint64_t names_off;
+    uint64_t file_size;
+};
+
+static uint64_t align8(uint64_t v){ return (v + 7) & ~uint64_t(7); }
+
+bool compile_scenario(const std::string& in_path, const std::string& out_path){
+    PhysicsEngine e;
+    ScenarioCfg cfg = load_scenario(in_path, e);
+    if(e.bodies.empty()){
+        std::cerr << "compile_scenario: no entities in " << in_path << "\n";
+        return false;
+    }
+
+    SnapHeader h{};
+    std::memcpy(h.magic, SNAP_MAGIC, sizeof(h.magic));
+    h.version    = SNAP_VERSION;
+    h.cfg_size   = sizeof(ScenarioCfg);
+    h.body_size  = sizeof(Body);
+    h.surface_size = sizeof(BodySurface);
+    h.n_bodies   = e.bodies.size();
+    h.n_surfaces = e.surfaces.size() == e.bodies.size() ? e.surfaces.size() : 0;
+    h.cfg_off    = align8(sizeof(SnapHeader));
+    h.bodies_off = align8(h.cfg_off + sizeof(ScenarioCfg));
+    h.surfaces_off = h.bodies_off + h.n_bodies*sizeof(Body);
+    h.names_off  = h.surfaces_off + h.n_surfaces*sizeof(BodySurface);
+
+    uint64_t names_bytes = h.n_bodies*sizeof(uint32_t);
+    for(const auto& n : e.names) names_bytes += n.size();
+    h.file_size = h.names_off + names_bytes;
+
+    std::ofstream out(out_path, std::ios::binary);
+    if(!out) return false;
+
+    auto pad_to = [&](uint64_t off){
+        static const char zeros[8] = {};
+        uint64_t cur = (uint64_t)out.tellp();
+        if(off > cur) out.write(zeros, (std::streamsize)(off - cur));
+    };
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    pad_to(h.cfg_off);
+    out.write(reinterpret_cast<const char*>(&cfg), sizeof(cfg));
+    pad_to(h.bodies_off);
+    out.write(reinterpret_cast<const char*>(e.bodies.data()), (std::streamsize)(h.n_bodies*sizeof(Body)));
+    out.write(reinterpret_cast<const char*>(e.surfaces.data()), (std::streamsize)(h.n_surfaces*sizeof(BodySurface)));
+    for(const auto& n : e.names){
+        uint32_t len = (uint32_t)n.size();
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    }
+    for(const auto& n : e.names) out.write(n.data(), (std::streamsize)n.size());
+
+    return (bool)out;
+}
+
+bool is_scenario_snapshot(const std::string& path){
+    if(path.size() > 4 && path.compare(path.size() - 4, 4, ".scn") == 0) return true;
+    std::ifstream f(path, std::ios::binary);
+    char m[sizeof(SNAP_MAGIC)] = {};
+    if(!f.read(m, sizeof(m))) return false;
+    return std::memcmp(m, SNAP_MAGIC, sizeof(m)) == 0;
+}
+
+bool load_scenario_snapshot(const std::string& path, PhysicsEngine& e, ScenarioCfg& cfg){
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        std::cerr << "load_scenario_snapshot: failed to open " << path << "\n";
+        return false;
+    }
+    struct stat st{};
+    if(::fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapHeader)){
+        std::cerr << "load_scenario_snapshot: truncated " << path << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    const size_t len = (size_t)st.st_size;
+    void* map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(map == MAP_FAILED){
+        std::cerr << "load_scenario_snapshot: mmap failed for " << path << "\n";
+        return false;
+    }
+    ::madvise(map, len, MADV_SEQUENTIAL);
+
+    const char* base = static_cast<const char*>(map);
+    SnapHeader h;
+    std::memcpy(&h, base, sizeof(h));
+
+    if(std::memcmp(h.magic, SNAP_MAGIC, sizeof(h.magic)) != 0 ||
+       h.version != SNAP_VERSION ||
+       h.cfg_size != sizeof(ScenarioCfg) ||
+       h.body_size != sizeof(Body) ||
+       h.surface_size != sizeof(BodySurface) ||
+       (h.n_surfaces != 0 && h.n_surfaces != h.n_bodies) ||
+       h.file_size != len ||
+       h.cfg_off + sizeof(ScenarioCfg) > h.bodies_off ||
+       h.bodies_off + h.n_bodies*sizeof(Body) > h.surfaces_off ||
+       h.surfaces_off + h.n_surfaces*sizeof(BodySurface) > h.names_off){
+        std::cerr << "load_scenario_snapshot: incompatible snapshot " << path
+                  << " (recompile with --compile)\n";
+        ::munmap(map, len);
+        return false;
+    }
+
+    // Validate the name table before touching the engine.
+    const char* lens = base + h.names_off;
+    const char* end = base + len;
+    if(h.names_off > len || h.n_bodies*sizeof(uint32_t) > len - h.names_off){
+        std::cerr << "load_scenario_snapshot: corrupt name table in " << path << "\n";
+        ::munmap(map, len);
+        return false;
+    }
+    const char* chars = lens + h.n_bodies*sizeof(uint32_t);
+    uint64_t name_bytes = 0;
+    for(uint64_t i=0;i<h.n_bodies;i++){
+        uint32_t n;
+        std::memcpy(&n, lens + i*sizeof(uint32_t), sizeof(n));
+        name_bytes += n;
+    }
+    if(name_bytes > (uint64_t)(end - chars)){
+        std::cerr << "load_scenario_snapshot: corrupt name table in " << path << "\n";
+        ::munmap(map, len);
+        return false;
+    }
+
+    std::memcpy(&cfg, base + h.cfg_off, sizeof(cfg));
+
+    // Body table is stored in engine layout; one bulk copy into engine storage.
+    const Body* src = reinterpret_cast<const Body*>(base + h.bodies_off);
+    const size_t first = e.bodies.size();
+    e.bodies.insert(e.bodies.end(), src, src + h.n_bodies);
+    if(h.n_surfaces){
+        const BodySurface* ss = reinterpret_cast<const BodySurface*>(base + h.surfaces_off);
+        e.surfaces.resize(first);
+        e.surfaces.insert(e.surfaces.end(), ss, ss + h.n_surfaces);
+    }
+
+    e.names.reserve(e.names.size() + h.n_bodies);
+    for(uint64_t i=0;i<h.n_bodies;i++){
+        uint32_t n;
+        std::memcpy(&n, lens + i*sizeof(uint32_t), sizeof(n));
+        e.names.emplace_back(chars, n);
+        chars += n;
+    }
+
+    ::munmap(map, len);
+    return true;
+}
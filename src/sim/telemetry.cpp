@@ -0,0 +1,230 @@
+#include "sim/telemetry.hpp"
+#include "core/strings.hpp"
+#include "sim/local_socket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr size_t TELEMETRY_MAX_REQUEST = 1u<<16;
+
+static double wall_s(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void put_header(std::vector<char>& f, uint16_t type, const StateSnapshot& s, uint32_t count){
+    const TelemetryFrameHeader h{TELEMETRY_MAGIC, TELEMETRY_VERSION, type, s.seq, s.time, count,
+                                 (uint32_t)(f.size() - sizeof(TelemetryFrameHeader))};
+    std::memcpy(f.data(), &h, sizeof(h));
+}
+
+TelemetryServer::TelemetryServer(StatePublisher& pub, const TelemetryOptions& opt) : pub(pub), opt(opt) {}
+
+TelemetryServer::~TelemetryServer(){ stop(); }
+
+bool TelemetryServer::start(){
+    listen_fd = local_listen(opt.endpoint, unix_path, "telemetry");
+    if(listen_fd < 0) return false;
+    reader = pub.add_reader();
+    running = true;
+    worker = std::thread([this]{ run(); });
+    std::cout << "telemetry listening on " << opt.endpoint << std::endl;
+    return true;
+}
+
+void TelemetryServer::stop(){
+    if(!running.exchange(false)) return;
+    worker.join();
+    for(auto& c : clients) close_client(*c);
+    clients.clear();
+    ::close(listen_fd);
+    listen_fd = -1;
+    if(!unix_path.empty()) ::unlink(unix_path.c_str());
+}
+
+void TelemetryServer::close_client(Client& c){
+    if(c.fd >= 0) ::close(c.fd);
+    c.fd = -1;
+}
+
+// Keeps a partly sent head frame so the stream stays framed, replaces the
+// rest of the backlog with a DROP frame and stops feeding the client.
+void TelemetryServer::drop_client(Client& c, const StateSnapshot& s, double now_s){
+    while(c.queue.size() > (c.head_sent ? 1u : 0u)){
+        c.queued -= c.queue.back().size();
+        c.queue.pop_back();
+    }
+    std::vector<char> f(sizeof(TelemetryFrameHeader));
+    put_header(f, TELEMETRY_DROP, s, 0);
+    c.queued += f.size();
+    c.queue.push_back(std::move(f));
+    c.dropping = true;
+    c.drop_deadline_s = now_s + opt.drop_linger_s;
+    dropped++;
+}
+
+void TelemetryServer::accept_clients(){
+    for(;;){
+        const int fd = ::accept(listen_fd, nullptr, nullptr);
+        if(fd < 0) return;
+        if(clients.size() >= opt.max_clients){
+            ::close(fd);
+            continue;
+        }
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        auto c = std::make_unique<Client>();
+        c->fd = fd;
+        clients.push_back(std::move(c));
+        served++;
+    }
+}
+
+// Reads whatever has arrived and applies complete SUB lines; false once
+// the peer has closed or sent something unusable.
+bool TelemetryServer::read_requests(Client& c){
+    char buf[4096];
+    for(;;){
+        const ssize_t n = ::recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if(n == 0) return false;
+        if(n < 0) break;
+        c.inbox.append(buf, (size_t)n);
+        if(c.inbox.size() > TELEMETRY_MAX_REQUEST) return false;
+    }
+    if(errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+    size_t nl;
+    while((nl = c.inbox.find('\n')) != std::string::npos){
+        std::string line = c.inbox.substr(0, nl);
+        c.inbox.erase(0, nl + 1);
+        if(!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream in(line);
+        std::string cmd, names;
+        double hz = 0.0;
+        if(!(in >> cmd >> hz) || cmd != "SUB" || hz < 0.0) return false;
+        std::getline(in >> std::ws, names);
+        c.want.clear();
+        if(names != "*" && !names.empty()){
+            std::stringstream ss(names);
+            std::string name;
+            while(std::getline(ss, name, ',')) if(!name.empty()) c.want.push_back(trimmed(name));
+        }
+        c.max_hz = hz;
+        c.subscribed = true;
+        c.need_schema = true;
+        c.next_send_s = 0.0;
+    }
+    return true;
+}
+
+void TelemetryServer::enqueue(Client& c, const StateSnapshot& s, double now_s){
+    if(!c.subscribed || s.seq == 0 || s.seq == c.last_seq) return;
+    if(c.max_hz > 0.0 && now_s < c.next_send_s) return;
+
+    if(c.need_schema || c.sel_for_bodies != s.bodies.size()){
+        c.sel.clear();
+        const size_t n = std::min(s.bodies.size(), s.names.size());
+        if(c.want.empty()){
+            for(size_t i=0;i<n;i++) c.sel.push_back((uint32_t)i);
+        }else{
+            for(const auto& w : c.want)
+                for(size_t i=0;i<n;i++)
+                    if(trimmed(s.names[i]) == w){ c.sel.push_back((uint32_t)i); break; }
+        }
+        std::vector<char> f(sizeof(TelemetryFrameHeader));
+        for(uint32_t i : c.sel){
+            const std::string& name = s.names[i];
+            const uint16_t len = (uint16_t)std::min<size_t>(name.size(), 0xffff);
+            const size_t at = f.size();
+            f.resize(at + 6 + len);
+            std::memcpy(f.data() + at, &i, 4);
+            std::memcpy(f.data() + at + 4, &len, 2);
+            std::memcpy(f.data() + at + 6, name.data(), len);
+        }
+        put_header(f, TELEMETRY_SCHEMA, s, (uint32_t)c.sel.size());
+        c.queued += f.size();
+        c.queue.push_back(std::move(f));
+        c.sel_for_bodies = s.bodies.size();
+        c.need_schema = false;
+    }
+
+    std::vector<char> f(sizeof(TelemetryFrameHeader) + TELEMETRY_STATE_RECORD*c.sel.size());
+    char* p = f.data() + sizeof(TelemetryFrameHeader);
+    for(uint32_t i : c.sel){
+        const Body& b = s.bodies[i];
+        const double rec[6] = {b.x, b.y, b.z, b.vx, b.vy, b.vz};
+        std::memcpy(p, rec, sizeof(rec));
+        p += sizeof(rec);
+    }
+    put_header(f, TELEMETRY_STATE, s, (uint32_t)c.sel.size());
+    c.queued += f.size();
+    c.queue.push_back(std::move(f));
+
+    c.last_seq = s.seq;
+    if(c.max_hz > 0.0){
+        // Keep the cadence, but never bank sends while there was nothing new.
+        c.next_send_s += 1.0/c.max_hz;
+        if(c.next_send_s <= now_s) c.next_send_s = now_s + 1.0/c.max_hz;
+    }
+}
+
+// Sends as much of the queue as the socket takes without blocking.
+bool TelemetryServer::flush(Client& c){
+    while(!c.queue.empty()){
+        const std::vector<char>& f = c.queue.front();
+        const ssize_t n = ::send(c.fd, f.data() + c.head_sent, f.size() - c.head_sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c.head_sent += (size_t)n;
+        if(c.head_sent == f.size()){
+            c.queued -= f.size();
+            c.head_sent = 0;
+            c.queue.pop_front();
+        }
+    }
+    return true;
+}
+
+void TelemetryServer::run(){
+    std::vector<pollfd> fds;
+    while(running.load(std::memory_order_relaxed)){
+        fds.assign(1, pollfd{listen_fd, POLLIN, 0});
+        for(const auto& c : clients)
+            fds.push_back(pollfd{c->fd, (short)((c->dropping ? 0 : POLLIN) | (c->queue.empty() ? 0 : POLLOUT)), 0});
+        ::poll(fds.data(), fds.size(), opt.poll_ms);
+
+        for(size_t k=0;k<clients.size();k++){
+            Client& c = *clients[k];
+            const short ev = fds[k+1].revents;
+            if(c.dropping){
+                if(ev & (POLLHUP | POLLERR)) close_client(c);
+            }else if((ev & (POLLIN | POLLHUP | POLLERR)) && !read_requests(c)){
+                close_client(c);
+            }
+        }
+        if(fds[0].revents & POLLIN) accept_clients();
+
+        const StateSnapshot& s = pub.latest(reader);
+        const double now = wall_s();
+        for(auto& cp : clients){
+            Client& c = *cp;
+            if(c.fd < 0) continue;
+            if(!c.dropping) enqueue(c, s, now);
+            if(!flush(c)){ close_client(c); continue; }
+            if(c.dropping){
+                if(c.queue.empty() || now > c.drop_deadline_s) close_client(c);
+            }else if(c.queued > opt.max_queue_bytes){
+                std::cerr << "telemetry: dropping slow client (" << c.queued << " bytes queued)\n";
+                drop_client(c, s, now);
+                if(!flush(c) || c.queue.empty()) close_client(c);
+            }
+        }
+        clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                     [](const std::unique_ptr<Client>& c){ return c->fd < 0; }),
+                      clients.end());
+    }
+}
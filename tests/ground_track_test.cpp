@@ -0,0 +1,66 @@
+// Ground-track longitude of an equatorial GEO satellite against GMST: the
+// engine is stepped the way run_model does (step, then tick), and every
+// row must match atan2(y, x) - GMST at the time the state is valid. A
+// track evaluated one step off the states is rotated by w_E*dt = 0.25 deg.
+#include "core/geodesy.hpp"
+#include "core/output.hpp"
+#include "physics/engine.hpp"
+#include "physics/orbit.hpp"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static constexpr double PI = 3.14159265358979323846;
+
+int main(){
+    PhysicsEngine e;
+    e.epoch_jd = 2451545.0;
+    e.add(coe_to_body_eci(COE{42166.3, 0.0, 0.0, 0.0, 0.0, 0.0}), "Ace");
+
+    const std::string path = "ground_track_test.csv";
+    const double dt = 60.0, t_end = 6.0*3600.0;
+    std::vector<double> expect;
+    {
+        OutputWriter ow;
+        ow.open(path, dt);
+        for(double t=0.0;t<=t_end;t+=dt){
+            e.step(dt);
+            ow.tick(t, e);
+            const Body& b = e.bodies[0];
+            double lon = std::fmod((std::atan2(b.y, b.x) - gmst_rad(e.epoch_jd + e.time/86400.0))*180.0/PI, 360.0);
+            if(lon > 180.0) lon -= 360.0;
+            if(lon < -180.0) lon += 360.0;
+            expect.push_back(lon);
+        }
+    }
+
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    size_t rows = 0;
+    double worst = 0.0;
+    while(std::getline(in, line)){
+        std::vector<std::string> f;
+        std::stringstream ss(line);
+        std::string cell;
+        while(std::getline(ss, cell, ',')) f.push_back(cell);
+        if(f.size() != 12){
+            std::fprintf(stderr, "ground_track_test: bad row '%s'\n", line.c_str());
+            return 1;
+        }
+        if(rows >= expect.size()) return 1;
+        const double lat = std::stod(f[9]), lon = std::stod(f[10]);
+        worst = std::fmax(worst, std::fmax(std::fabs(lat), std::fabs(lon - expect[rows])));
+        rows++;
+    }
+    std::printf("ground_track_test rows %zu lon0_deg %.4f worst_err_deg %.5f\n", rows, expect[0], worst);
+    // rows carry 6 significant digits
+    if(rows != expect.size() || worst > 1e-3){
+        std::fprintf(stderr, "ground_track_test: sub-satellite point off by %.4f deg\n", worst);
+        return 1;
+    }
+    return 0;
+}
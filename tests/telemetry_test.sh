@@ -0,0 +1,27 @@
+#!/bin/sh
+# Real-time sim with telemetry, checked by the bundled client: framing on a
+# normal subscription, then a stalled client that the server must drop
+# with a DROP frame.
+# usage: telemetry_test.sh <spacesim2> <spacesim2-telemetry> <scenario>
+sim=$1
+client=$2
+scenario=$3
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+endpoint="unix:$dir/telemetry.sock"
+
+"$sim" --sim "$scenario" --speed 600 --telemetry "$endpoint" --telemetry-queue 1000000 > "$dir/sim.log" 2>&1 &
+pid=$!
+i=0
+while [ ! -S "$dir/telemetry.sock" ] && [ $i -lt 100 ]; do
+    sleep 0.1
+    i=$((i + 1))
+done
+
+rc=0
+"$client" "$endpoint" --frames 20 --quiet || rc=1
+"$client" "$endpoint" --stall 2 || rc=1
+wait $pid || rc=1
+cat "$dir/sim.log"
+grep -q "telemetry clients 2 dropped 1" "$dir/sim.log" || rc=1
+exit $rc